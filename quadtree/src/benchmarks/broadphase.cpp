@@ -0,0 +1,164 @@
+// Runs every broad-phase backend against every scenario and reports the deepest tree, the candidate
+// pairs per particle and the step time. After the run the colliding pairs each backend finds are
+// checked against the brute force ones on the same positions, the process fails on a mismatch.
+// Headless, run it with: benchmark_broadphase [particles_count] [steps] [scenario]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+#include "../core/spatial_index.hpp"
+#include "../core/simulation.hpp"
+#include "../core/scenarios.hpp"
+
+const float delta_time = 1.f / 60.f;
+const float radius = 3.f;
+const unsigned seed = 42;
+// the brute force index is quadratic, it's skipped above this many particles
+const unsigned brute_force_limit = 20000;
+
+// forwards for_each_pair to an index, counting the candidate pairs
+template<typename Index>
+struct CountingIndex {
+    Index& index;
+    size_t candidates = 0;
+
+    template<typename Function>
+    void for_each_pair(unsigned begin, unsigned end, Function&& function)
+    {
+        index.for_each_pair(begin, end, [this, &function](Particle& particle, Particle& other) {
+            candidates++;
+            function(particle, other);
+        });
+    }
+};
+
+using Pair = std::pair<unsigned, unsigned>;
+
+// intersecting pairs reported by index on particles, sorted
+template<typename Index>
+static std::vector<Pair> colliding_pairs(Index& index, Particle* particles, unsigned count)
+{
+    std::vector<Pair> pairs;
+    index.for_each_pair(0, count, [particles, &pairs](Particle& particle, Particle& other) {
+        if (particle.intersect(other))
+        {
+            unsigned i = (unsigned) (&particle - particles), j = (unsigned) (&other - particles);
+            pairs.emplace_back(glm::min(i, j), glm::max(i, j));
+        }
+    });
+    std::sort(pairs.begin(), pairs.end());
+
+    return pairs;
+}
+
+// false when index misses or invents a colliding pair, the index is rebuilt as a step would
+template<typename Index>
+static bool check_pairs(Index& index, std::vector<Particle>& particles, const World& world)
+{
+    unsigned count = (unsigned) particles.size();
+    if (count > brute_force_limit)
+    {
+        std::printf("   pairs unchecked\n");
+        return true;
+    }
+
+    index.build(particles.data(), count, world, delta_time);
+    std::vector<Pair> pairs = colliding_pairs(index, particles.data(), count);
+
+    BruteForceIndex reference;
+    reference.build(particles.data(), count, world, delta_time);
+    std::vector<Pair> expected = colliding_pairs(reference, particles.data(), count);
+
+    bool match = pairs == expected;
+    std::printf("   pairs %zu %s\n", pairs.size(), match ? "ok" : "MISMATCH");
+    if (!match)
+    {
+        std::printf("ERROR::BROADPHASE::PAIRS_MISMATCH %s found %zu pairs, brute force %zu\n", Index::name(), pairs.size(), expected.size());
+    }
+
+    return match;
+}
+
+// rebuilds are what the neighbor lists save, the other backends rebuild every step
+template<typename Index>
+static void print_rebuilds(const Index&, unsigned)
+{
+}
+
+static void print_rebuilds(const NeighborListIndex& index, unsigned steps)
+{
+    std::printf("   rebuilds %u/%u skin %.2f", index.get_rebuild_count(), steps, index.get_skin());
+}
+
+template<typename Index>
+static bool run_index(const Scenario& scenario, unsigned count, unsigned steps)
+{
+    World world = {AABB::from_center({0.f, 0.f}, {640.f, 360.f})};
+    std::vector<Particle> particles = generate_particles(scenario, count, world.bounds, radius, seed);
+
+    Index index;
+    CountingIndex<Index> counting = {index};
+    unsigned depth = 0;
+
+    double elapsed_ms = measure_ms([&]() {
+        for (unsigned step = 0; step < steps; step++)
+        {
+            index.build(particles.data(), count, world, delta_time);
+            depth = glm::max(depth, index.depth());
+
+            update_physics(counting, particles.data(), 0, count, world, delta_time);
+        }
+    });
+
+    std::printf("  %-14s depth %3u   candidates %9.1f per particle   %9.3f ms/step",
+                Index::name(), depth, (double) counting.candidates / steps / count, elapsed_ms / steps);
+    print_rebuilds(index, steps);
+
+    return check_pairs(index, particles, world);
+}
+
+static bool run(const Scenario& scenario, unsigned count, unsigned steps)
+{
+    std::printf("%s (%s), %u particles, %u steps\n", scenario.name, scenario.description, count, steps);
+
+    bool match = true;
+    if (count <= brute_force_limit)
+    {
+        match &= run_index<BruteForceIndex>(scenario, count, steps);
+    }
+    match &= run_index<QuadTreeIndex>(scenario, count, steps);
+    match &= run_index<SpatialTreeIndex<>>(scenario, count, steps);
+    match &= run_index<NeighborListIndex>(scenario, count, steps);
+
+    return match;
+}
+
+int main(int argc, char const *argv[])
+{
+    unsigned count = argc > 1 ? (unsigned) std::strtoul(argv[1], nullptr, 10) : 15000;
+    unsigned steps = argc > 2 ? glm::max(1u, (unsigned) std::strtoul(argv[2], nullptr, 10)) : 20;
+
+    if (argc > 3)
+    {
+        const Scenario* scenario = find_scenario(argv[3]);
+        if (!scenario)
+        {
+            std::printf("ERROR::SCENARIO::UNKNOWN %s\n", argv[3]);
+            return 1;
+        }
+
+        return run(*scenario, count, steps) ? 0 : 1;
+    }
+
+    bool match = true;
+    for (const Scenario& scenario : get_scenarios())
+    {
+        match &= run(scenario, count, steps);
+    }
+
+    return match ? 0 : 1;
+}
@@ -0,0 +1,19 @@
+#ifndef SPATIAL_DATA_PARTITIONING_BENCHMARKS_COMMON_HPP
+#define SPATIAL_DATA_PARTITIONING_BENCHMARKS_COMMON_HPP
+
+#include <chrono>
+
+// shared by the headless benchmarks, which can't include core/common.hpp and its window headers
+
+using Clock = std::chrono::high_resolution_clock;
+
+// wall time of function, in milliseconds
+template<typename Function>
+double measure_ms(Function&& function)
+{
+    auto start = Clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+#endif //SPATIAL_DATA_PARTITIONING_BENCHMARKS_COMMON_HPP
@@ -0,0 +1,183 @@
+// Compares the memory and step time of the regular particles and QuadTree against the compact mode.
+// The world grows with the particle count so the density stays the one of the examples.
+// After the run, the colliding pairs the compact quadtree finds are checked against the regular
+// QuadTree on the same decoded particles, the process fails on a mismatch.
+// Headless, run it with: benchmark_compact [particles_count] [steps]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "common.hpp"
+#include "../core/quadtree.h"
+#include "../core/simulation.hpp"
+#include "../core/compact.hpp"
+#include "../core/scenarios.hpp"
+
+// the examples simulate 15000 particles in 1280x720
+const float particles_per_pixel = 15000.f / (1280.f * 720.f);
+const float delta_time = 1.f / 60.f;
+
+static World make_world(unsigned count)
+{
+    float scale = std::sqrt((float) count / particles_per_pixel / (1280.f * 720.f));
+    glm::vec2 half_size = glm::vec2(640.f, 360.f) * scale;
+
+    return {{-half_size, half_size}};
+}
+
+static double kinetic_energy(const std::vector<Particle>& particles)
+{
+    double energy = 0;
+    for (const Particle& particle : particles)
+    {
+        energy += 0.5 * particle.radius * glm::dot(particle.velocity, particle.velocity);
+    }
+
+    return energy;
+}
+
+// same step as collisions_quadtree, returns the memory of the particles and of the tree
+static size_t step_regular(std::vector<Particle>& particles, const World& world, std::vector<Particle*>& found)
+{
+    QuadTree tree(world.bounds, 6);
+    for (Particle& particle : particles)
+    {
+        tree.insert(&particle);
+    }
+
+    for (Particle& particle : particles)
+    {
+        found.clear();
+        tree.query(&particle, &found);
+
+        for (Particle* other : found)
+        {
+            if (other > &particle && particle.intersect(*other))
+            {
+                resolve_collision(particle, *other);
+            }
+        }
+    }
+
+    for (Particle& particle : particles)
+    {
+        resolve_bounds(particle, world.bounds);
+        particle.position += particle.velocity * delta_time;
+    }
+
+    return particles.capacity() * sizeof(Particle) + tree.memory();
+}
+
+using Pair = std::pair<uint32_t, uint32_t>;
+
+// intersecting pairs (i < j) found by a regular QuadTree, sorted
+static std::vector<Pair> regular_pairs(std::vector<Particle>& particles)
+{
+    // decoded positions may lie slightly past the world, the root holds them all
+    AABB bounds = {particles[0].position, particles[0].position};
+    for (const Particle& particle : particles)
+    {
+        bounds.min = glm::min(bounds.min, particle.position);
+        bounds.max = glm::max(bounds.max, particle.position);
+    }
+
+    QuadTree tree({bounds.min - 1.f, bounds.max + 1.f}, 6);
+    for (Particle& particle : particles)
+    {
+        tree.insert(&particle);
+    }
+
+    std::vector<Pair> pairs;
+    std::vector<Particle*> found;
+    for (Particle& particle : particles)
+    {
+        found.clear();
+        tree.query(&particle, &found);
+
+        for (Particle* other : found)
+        {
+            if (other > &particle && particle.intersect(*other))
+            {
+                pairs.emplace_back((uint32_t) (&particle - particles.data()), (uint32_t) (other - particles.data()));
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    return pairs;
+}
+
+static bool run(unsigned count, unsigned steps)
+{
+    World world = make_world(count);
+    std::vector<Particle> particles = generate_particles(*find_scenario("uniform"), count, world.bounds, 3.f, 42);
+    double initial_energy = kinetic_energy(particles);
+
+    std::printf("%u particles, %u steps\n", count, steps);
+
+    // regular
+    std::vector<Particle*> found;
+    size_t regular_memory = 0;
+    std::vector<Particle> regular = particles;
+    double regular_ms = measure_ms([&]() {
+        for (unsigned i = 0; i < steps; i++)
+        {
+            regular_memory = step_regular(regular, world, found);
+        }
+    });
+
+    // compact
+    CompactSimulation compact(world);
+    compact.assign(particles.data(), count);
+    double compact_ms = measure_ms([&]() {
+        for (unsigned i = 0; i < steps; i++)
+        {
+            compact.step(delta_time);
+        }
+    });
+    std::vector<Particle> unpacked(count);
+    compact.unpack(unpacked.data());
+
+    std::printf("  regular  %8.1f MB   %9.2f ms/step   energy %+.2f%%\n",
+                (double) regular_memory / 1e6, regular_ms / steps, 100.0 * (kinetic_energy(regular) / initial_energy - 1.0));
+    std::printf("  compact  %8.1f MB   %9.2f ms/step   energy %+.2f%%\n",
+                (double) compact.memory() / 1e6, compact_ms / steps, 100.0 * (kinetic_energy(unpacked) / initial_energy - 1.0));
+    std::printf("  memory %.2fx smaller, step %.2fx faster\n",
+                (double) regular_memory / (double) compact.memory(), regular_ms / compact_ms);
+
+    // unpack follows the compact order, so the indices of both sides match
+    std::vector<Pair> pairs;
+    compact.find_pairs(&pairs);
+    std::sort(pairs.begin(), pairs.end());
+    std::vector<Pair> expected = regular_pairs(unpacked);
+
+    bool match = pairs == expected;
+    std::printf("  pairs %zu %s\n", pairs.size(), match ? "ok" : "MISMATCH");
+    if (!match)
+    {
+        std::printf("ERROR::COMPACT::PAIRS_MISMATCH compact found %zu pairs, quadtree %zu\n", pairs.size(), expected.size());
+    }
+
+    return match;
+}
+
+int main(int argc, char const *argv[])
+{
+    unsigned steps = argc > 2 ? (unsigned) std::strtoul(argv[2], nullptr, 10) : 10;
+
+    if (argc > 1)
+    {
+        return run((unsigned) std::strtoul(argv[1], nullptr, 10), steps) ? 0 : 1;
+    }
+
+    bool match = true;
+    for (unsigned count : {100000u, 1000000u, 10000000u})
+    {
+        match &= run(count, steps);
+    }
+
+    return match ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+// Steps every scenario with the IslandSolver and reports the sleeping particles, the islands and the
+// step time against update_physics. The resting scenario must reach sleep, the process fails otherwise.
+// Headless, run it with:
+//   benchmark_islands [particles_count] [steps] [scenario|all] [sleep_velocity] [sleep_impulse] [sleep_steps]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "common.hpp"
+#include "../core/spatial_index.hpp"
+#include "../core/simulation.hpp"
+#include "../core/scenarios.hpp"
+
+const float delta_time = 1.f / 60.f;
+const float radius = 3.f;
+const unsigned seed = 42;
+
+static bool run(const Scenario& scenario, unsigned count, unsigned steps, const SleepThresholds& thresholds)
+{
+    World world = {AABB::from_center({0.f, 0.f}, {640.f, 360.f})};
+    std::vector<Particle> particles = generate_particles(scenario, count, world.bounds, radius, seed);
+    std::vector<Particle> regular = particles;
+
+    std::printf("%s (%s), %u particles, %u steps\n", scenario.name, scenario.description, count, steps);
+
+    QuadTreeIndex index;
+    double regular_ms = measure_ms([&]() {
+        for (unsigned step = 0; step < steps; step++)
+        {
+            index.build(regular.data(), count, world, delta_time);
+            update_physics(index, regular.data(), 0, count, world, delta_time);
+        }
+    });
+
+    IslandSolver solver(thresholds);
+    unsigned peak_sleeping = 0;
+    size_t islands = 0;
+    double islands_ms = measure_ms([&]() {
+        for (unsigned step = 0; step < steps; step++)
+        {
+            index.build(particles.data(), count, world, delta_time);
+            solver.step(index, particles.data(), count, world, delta_time);
+
+            peak_sleeping = glm::max(peak_sleeping, solver.get_sleeping_count());
+            islands += solver.get_island_count();
+        }
+    });
+
+    std::printf("  update_physics %9.3f ms/step\n", regular_ms / steps);
+    std::printf("  islands        %9.3f ms/step   sleeping %6u at the end, %6u at most   islands %9.1f per step\n",
+                islands_ms / steps, solver.get_sleeping_count(), peak_sleeping, (double) islands / steps);
+
+    if (std::strcmp(scenario.name, "resting") == 0 && peak_sleeping == 0)
+    {
+        std::printf("ERROR::ISLANDS::NO_SLEEP nothing fell asleep in %u steps\n", steps);
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char const *argv[])
+{
+    unsigned count = argc > 1 ? (unsigned) std::strtoul(argv[1], nullptr, 10) : 15000;
+    unsigned steps = argc > 2 ? glm::max(1u, (unsigned) std::strtoul(argv[2], nullptr, 10)) : 300;
+
+    SleepThresholds thresholds;
+    if (argc > 4)
+    {
+        thresholds.velocity = std::strtof(argv[4], nullptr);
+    }
+    if (argc > 5)
+    {
+        thresholds.impulse = std::strtof(argv[5], nullptr);
+    }
+    if (argc > 6)
+    {
+        thresholds.steps = (unsigned) std::strtoul(argv[6], nullptr, 10);
+    }
+
+    if (argc > 3 && std::strcmp(argv[3], "all") != 0)
+    {
+        const Scenario* scenario = find_scenario(argv[3]);
+        if (!scenario)
+        {
+            std::printf("ERROR::SCENARIO::UNKNOWN %s\n", argv[3]);
+            return 1;
+        }
+
+        return run(*scenario, count, steps, thresholds) ? 0 : 1;
+    }
+
+    bool slept = true;
+    for (const Scenario& scenario : get_scenarios())
+    {
+        slept &= run(scenario, count, steps, thresholds);
+    }
+
+    return slept ? 0 : 1;
+}
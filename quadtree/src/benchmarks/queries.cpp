@@ -0,0 +1,147 @@
+// Compares the QuadTree range, radius and nearest neighbour queries against a linear scan.
+// Headless, run it with: benchmark_queries [particles_count]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "common.hpp"
+#include "../core/quadtree.h"
+#include "../core/scenarios.hpp"
+
+const float world_half_width = 640.f;
+const float world_half_height = 360.f;
+const unsigned queries_count = 1000;
+const unsigned nearest_k = 16;
+
+static void report(const char* name, double tree_ms, double linear_ms, bool matches)
+{
+    std::printf("  %-8s quadtree %9.3f ms   linear %9.3f ms   speedup %7.1fx   %s\n",
+                name, tree_ms, linear_ms, linear_ms / tree_ms, matches ? "ok" : "MISMATCH");
+}
+
+static void run(unsigned count)
+{
+    AABB world = AABB::from_center({0.f, 0.f}, {world_half_width, world_half_height});
+    std::vector<Particle> particles = generate_particles(*find_scenario("uniform"), count, world, 3.f, 42);
+
+    QuadTree tree({0.f, 0.f}, {world_half_width, world_half_height}, 6);
+    double build_ms = measure_ms([&]() {
+        for (Particle& particle : particles)
+        {
+            tree.insert(&particle);
+        }
+    });
+
+    std::printf("%u particles, build %.3f ms\n", count, build_ms);
+
+    auto generator = std::default_random_engine(7);
+    std::uniform_real_distribution<float> x_distribution(-world_half_width, world_half_width);
+    std::uniform_real_distribution<float> y_distribution(-world_half_height, world_half_height);
+    std::uniform_real_distribution<float> size_distribution(5.f, 50.f);
+
+    std::vector<glm::vec2> points(queries_count);
+    std::vector<float> sizes(queries_count);
+    for (unsigned i = 0; i < queries_count; i++)
+    {
+        points[i] = {x_distribution(generator), y_distribution(generator)};
+        sizes[i] = size_distribution(generator);
+    }
+
+    std::vector<Particle*> found;
+    size_t tree_found = 0, linear_found = 0;
+
+    // range
+    double tree_ms = measure_ms([&]() {
+        for (unsigned i = 0; i < queries_count; i++)
+        {
+            found.clear();
+            tree.query_range(AABB::from_center(points[i], glm::vec2(sizes[i])), &found);
+            tree_found += found.size();
+        }
+    });
+    double linear_ms = measure_ms([&]() {
+        for (unsigned i = 0; i < queries_count; i++)
+        {
+            AABB range = AABB::from_center(points[i], glm::vec2(sizes[i]));
+            for (Particle& particle : particles)
+            {
+                linear_found += range.contains(particle.position);
+            }
+        }
+    });
+    report("range", tree_ms, linear_ms, tree_found == linear_found);
+
+    // radius
+    tree_found = linear_found = 0;
+    tree_ms = measure_ms([&]() {
+        for (unsigned i = 0; i < queries_count; i++)
+        {
+            found.clear();
+            tree.query_radius(points[i], sizes[i], &found);
+            tree_found += found.size();
+        }
+    });
+    linear_ms = measure_ms([&]() {
+        for (unsigned i = 0; i < queries_count; i++)
+        {
+            float radius2 = sizes[i] * sizes[i];
+            for (Particle& particle : particles)
+            {
+                glm::vec2 delta = particle.position - points[i];
+                linear_found += glm::dot(delta, delta) <= radius2;
+            }
+        }
+    });
+    report("radius", tree_ms, linear_ms, tree_found == linear_found);
+
+    // k nearest, compare the distance of the k-th neighbour, fewer particles than k give all of them
+    unsigned k = std::min(nearest_k, count);
+    std::vector<float> tree_kth(queries_count), linear_kth(queries_count);
+    std::vector<float> distances(count);
+    tree_ms = measure_ms([&]() {
+        for (unsigned i = 0; i < queries_count; i++)
+        {
+            found.clear();
+            tree.nearest(points[i], k, &found);
+            tree_kth[i] = found.empty() ? 0.f : glm::distance(found.back()->position, points[i]);
+        }
+    });
+    linear_ms = measure_ms([&]() {
+        for (unsigned i = 0; i < queries_count; i++)
+        {
+            if (k == 0)
+            {
+                continue;
+            }
+
+            for (unsigned j = 0; j < count; j++)
+            {
+                glm::vec2 delta = particles[j].position - points[i];
+                distances[j] = glm::dot(delta, delta);
+            }
+            std::nth_element(distances.begin(), distances.begin() + (k - 1), distances.end());
+            linear_kth[i] = glm::sqrt(distances[k - 1]);
+        }
+    });
+    report("nearest", tree_ms, linear_ms, std::equal(tree_kth.begin(), tree_kth.end(), linear_kth.begin(),
+        [](float a, float b) { return glm::abs(a - b) < 1e-3f; }));
+}
+
+int main(int argc, char const *argv[])
+{
+    if (argc > 1)
+    {
+        run((unsigned) std::strtoul(argv[1], nullptr, 10));
+        return 0;
+    }
+
+    for (unsigned count : {15000u, 100000u, 1000000u})
+    {
+        run(count);
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Compares the QuadTree against the dimension generic SpatialTree, and times the octree.
+// Headless, run it with: benchmark_trees [particles_count]
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "common.hpp"
+#include "../core/quadtree.h"
+#include "../core/spatial_tree.hpp"
+
+const float world_half_width = 640.f;
+const float world_half_height = 360.f;
+const float world_half_depth = 360.f;
+const int repetitions = 10;
+
+template<typename Element>
+static std::vector<Element> generate_particles(unsigned count, unsigned seed)
+{
+    std::vector<Element> particles(count);
+    auto generator = std::default_random_engine(seed);
+    std::uniform_real_distribution<float> x_distribution(-world_half_width, world_half_width);
+    std::uniform_real_distribution<float> y_distribution(-world_half_height, world_half_height);
+    std::uniform_real_distribution<float> z_distribution(-world_half_depth, world_half_depth);
+
+    for (Element& particle : particles)
+    {
+        particle.position.x = x_distribution(generator);
+        particle.position.y = y_distribution(generator);
+        if constexpr (sizeof(particle.position) == sizeof(glm::vec3))
+        {
+            particle.position.z = z_distribution(generator);
+        }
+        particle.radius = 3.f;
+    }
+
+    return particles;
+}
+
+// average build and candidate query times of a tree over repetitions, plus the number of touching pairs
+template<typename Tree, typename Element, typename MakeTree>
+static void run_tree(const char* name, std::vector<Element>& particles, MakeTree&& make_tree)
+{
+    double build_ms = 0, query_ms = 0;
+    size_t candidates = 0, pairs = 0;
+    std::vector<Element*> found;
+
+    for (int r = 0; r < repetitions; r++)
+    {
+        Tree tree = make_tree();
+        build_ms += measure_ms([&]() {
+            for (Element& particle : particles)
+            {
+                tree.insert(&particle);
+            }
+        });
+
+        candidates = pairs = 0;
+        query_ms += measure_ms([&]() {
+            for (Element& particle : particles)
+            {
+                found.clear();
+                tree.query(&particle, &found);
+                candidates += found.size();
+                for (Element* other : found)
+                {
+                    pairs += other > &particle && particle.intersect(*other);
+                }
+            }
+        });
+    }
+
+    std::printf("  %-12s build %8.3f ms   query %8.3f ms   candidates %9zu   pairs %7zu\n",
+                name, build_ms / repetitions, query_ms / repetitions, candidates, pairs);
+}
+
+static void run(unsigned count)
+{
+    std::printf("%u particles\n", count);
+
+    std::vector<Particle> particles = generate_particles<Particle>(count, 42);
+    run_tree<QuadTree>("quadtree", particles, []() {
+        return QuadTree({0.f, 0.f}, {world_half_width, world_half_height}, 6);
+    });
+    run_tree<QuadTree2D>("spatial 2D", particles, []() {
+        return QuadTree2D({0.f, 0.f}, {world_half_width, world_half_height});
+    });
+
+    std::vector<Particle3D> particles_3d = generate_particles<Particle3D>(count, 42);
+    run_tree<Octree>("octree", particles_3d, []() {
+        return Octree({0.f, 0.f, 0.f}, {world_half_width, world_half_height, world_half_depth});
+    });
+}
+
+int main(int argc, char const *argv[])
+{
+    if (argc > 1)
+    {
+        run((unsigned) std::strtoul(argv[1], nullptr, 10));
+        return 0;
+    }
+
+    for (unsigned count : {1000u, 15000u, 100000u})
+    {
+        run(count);
+    }
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+// Headless simulation split into spatial domains, one process per domain (see core/domain.hpp).
+//
+//   collisions_domains [--domains P] [--particles N] [--steps S] [--scenario NAME] [--seed N]
+//   collisions_domains --benchmark    strong and weak scaling across 1 to 8 processes
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "core/domain.hpp"
+#include "core/scenarios.hpp"
+
+Application *Application::create_application() {
+    return new Application({"Collisions - Domains", 1280, 720});
+}
+
+// particles per unit of area of the windowed examples, the world grows to keep it
+const float density = (float) particles_count / (1280.f * 720.f);
+// percents the contacts of a split run may differ from a single process run
+const double contacts_tolerance = 2.0;
+
+static DomainConfig make_config(unsigned domains, unsigned count, unsigned steps, float aspect) {
+    // world of the requested aspect ratio holding count particles at the examples density
+    float area = (float) count / density;
+    float height = std::sqrt(area / aspect);
+
+    DomainConfig config;
+    config.world = AABB::from_center({0.f, 0.f}, glm::vec2(height * aspect, height) / 2.f);
+    config.domains = domains;
+    config.steps = steps;
+    config.ghost_width = 2.f * (float) max_radius;
+    config.capacity = std::max(4096u, count / domains);
+
+    return config;
+}
+
+// returns the slowest domain time per step in milliseconds, or a negative value on failure.
+// contacts receives the contacts resolved per step, a contact across a border counting once.
+static double run(DomainConfig config, unsigned count, const Scenario& scenario, unsigned seed, bool verbose, double* contacts = nullptr) {
+    std::vector<Particle> particles = generate_particles(scenario, count, config.world, (float) max_radius, seed);
+
+    // ghosts must reach as far as the largest particles can touch
+    for (const Particle& particle : particles) {
+        config.ghost_width = std::max(config.ghost_width, 2.f * particle.radius);
+    }
+
+    std::vector<DomainStats> stats = run_domains(config, particles);
+
+    if (stats.empty()) {
+        return -1.0;
+    }
+
+    double slowest = 0.0;
+    unsigned total = 0;
+    unsigned long long own_contacts = 0, border_contacts = 0;
+    for (unsigned domain = 0; domain < stats.size(); domain++) {
+        const DomainStats& domain_stats = stats[domain];
+        slowest = std::max(slowest, domain_stats.elapsed_ms);
+        total += domain_stats.particles;
+        own_contacts += domain_stats.contacts;
+        border_contacts += domain_stats.left_contacts + domain_stats.right_contacts;
+
+        if (verbose) {
+            std::printf("domain %u: %u particles, %.3f ms/step, %u ghosts received, %u migrants sent, %u overflows, %llu contacts\n",
+                        domain, domain_stats.particles, domain_stats.elapsed_ms / config.steps,
+                        domain_stats.ghosts_received, domain_stats.migrants_sent, domain_stats.overflows, domain_stats.contacts);
+        }
+    }
+
+    // both sides of a border resolve the same contacts, up to the order they're resolved in
+    for (unsigned domain = 0; verbose && domain + 1 < stats.size(); domain++) {
+        std::printf("border %u|%u: %llu contacts seen from the left, %llu from the right\n", domain, domain + 1,
+                    stats[domain].right_contacts, stats[domain + 1].left_contacts);
+    }
+
+    if (contacts) {
+        *contacts = ((double) own_contacts + (double) border_contacts / 2.0) / config.steps;
+    }
+
+    if (total != count) {
+        std::printf("ERROR::DOMAIN::PARTICLES_LOST %u of %u\n", count - total, count);
+    }
+
+    return slowest / config.steps;
+}
+
+static void benchmark(unsigned count, unsigned steps, const Scenario& scenario, unsigned seed) {
+    const unsigned domains[] = {1, 2, 4, 8};
+
+    std::printf("strong scaling, %u particles\n", count);
+    std::printf("  processes   ms/step   speedup   efficiency\n");
+    double baseline = 0.0;
+    for (unsigned p : domains) {
+        double ms = run(make_config(p, count, steps, 16.f / 9.f), count, scenario, seed, false);
+        if (p == 1) baseline = ms;
+        std::printf("  %9u %9.3f %9.2fx %11.0f%%\n", p, ms, baseline / ms, 100.0 * baseline / ms / p);
+    }
+
+    // every process keeps the same amount of work, the world gets wider with the processes
+    unsigned per_domain = count / 8;
+    std::printf("weak scaling, %u particles per process\n", per_domain);
+    std::printf("  processes   ms/step   efficiency\n");
+    for (unsigned p : domains) {
+        double ms = run(make_config(p, per_domain * p, steps, 16.f / 9.f * (float) p), per_domain * p, scenario, seed, false);
+        if (p == 1) baseline = ms;
+        std::printf("  %9u %9.3f %11.0f%%\n", p, ms, 100.0 * baseline / ms);
+    }
+}
+
+int main(int argc, char const *argv[]) {
+    unsigned domains = 4;
+    unsigned count = 60000;
+    unsigned steps = 200;
+    bool run_benchmark = false;
+    std::string scenario_name = "uniform";
+    unsigned seed = 42;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(argv[i], "--domains") == 0 && value) {
+            domains = std::max(1u, (unsigned) std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--particles") == 0 && value) {
+            count = (unsigned) std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--steps") == 0 && value) {
+            steps = std::max(1u, (unsigned) std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--scenario") == 0 && value) {
+            scenario_name = argv[++i];
+        } else if (std::strcmp(argv[i], "--seed") == 0 && value) {
+            seed = (unsigned) std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--benchmark") == 0) {
+            run_benchmark = true;
+        } else {
+            std::printf("WARNING::OPTIONS::UNKNOWN_ARGUMENT %s\n", argv[i]);
+        }
+    }
+
+    const Scenario* scenario = find_scenario(scenario_name);
+    if (!scenario) {
+        std::printf("ERROR::SCENARIO::UNKNOWN %s\n", scenario_name.c_str());
+        return 1;
+    }
+
+    if (run_benchmark) {
+        benchmark(count, steps, *scenario, seed);
+        return 0;
+    }
+
+    double contacts = 0.0;
+    double ms = run(make_config(domains, count, steps, 16.f / 9.f), count, *scenario, seed, true, &contacts);
+    if (ms < 0.0) {
+        return 1;
+    }
+
+    std::printf("%u processes, %u particles: %.3f ms/step, %.1f contacts/step\n", domains, count, ms, contacts);
+
+    // the same particles in a single process: the resolution order differs so the runs drift apart,
+    // but contacts lost or doubled at the borders show up as a gap
+    if (domains > 1) {
+        double single_contacts = 0.0;
+        if (run(make_config(1, count, steps, 16.f / 9.f), count, *scenario, seed, false, &single_contacts) < 0.0) {
+            return 1;
+        }
+
+        double difference = single_contacts > 0.0 ? 100.0 * (contacts / single_contacts - 1.0) : 0.0;
+        std::printf("1 process: %.1f contacts/step, %+.2f%%\n", single_contacts, difference);
+        if (std::abs(difference) > contacts_tolerance) {
+            std::printf("WARNING::DOMAIN::CONTACTS_MISMATCH %+.2f%% against a single process\n", difference);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <vector>
+#include <memory>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "core/particle.hpp"
+#include "core/application.hpp"
+#include "core/snapshot.hpp"
+#include "core/recorder.hpp"
+#include "core/simulation.hpp"
+#include "core/spatial_index.hpp"
+#include "core/renderer.hpp"
+
+Application *Application::create_application() {
+    return new Application({std::string("Collisions - ") + SelectedIndex::name(), 1280, 720});
+}
+
+int main(int argc, char const *argv[]) {
+    Options options = parse_options(argc, argv);
+
+    Application::get();
+
+    unsigned quadVAO = initQuad({0.0f, 0.0f});
+
+    auto* particles = new Particle[particles_count];
+    init_particles(particles, options);
+
+    if (!options.save_snapshot_path.empty()) {
+        Application::get()->register_system(snapshot_system(particles, particles_count, options.save_snapshot_path, options.snapshot_interval));
+    }
+
+    std::unique_ptr<TrajectoryRecorder> recorder;
+    if (!options.record_path.empty()) {
+        recorder = std::make_unique<TrajectoryRecorder>(options.record_path, particles_count);
+        Application::get()->register_system(recorder_system(recorder.get(), particles));
+    }
+
+    SelectedIndex index;
+
+    IslandSolver solver(options.sleep);
+    if (options.islands) {
+        Application::get()->register_stats([&solver]() { return solver.describe(); });
+    }
+
+    Application::get()->register_system([particles, &index, &solver, &options, quadVAO]() {
+        const World& world = Application::get()->get_world();
+
+        index.build(particles, particles_count, world, Application::delta_time);
+
+        index.draw(quadVAO, Application::get()->get_shader_program());
+
+        //update physics
+        if (options.islands) {
+            solver.step(index, particles, particles_count, world, Application::delta_time);
+        } else {
+            update_physics(index, particles, 0, particles_count, world, Application::delta_time);
+        }
+    });
+
+    ParticleRenderer renderer;
+
+    Application::get()->register_system([&renderer, &index]() {
+        //render particles
+        renderer.draw(index);
+    });
+
+    Application::get()->run();
+
+    recorder.reset();
+
+    glDeleteVertexArrays(1, &quadVAO);
+
+    return 0;
+}
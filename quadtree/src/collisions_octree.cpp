@@ -0,0 +1,143 @@
+#include <cmath>
+#include <vector>
+#include <random>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "core/particle.hpp"
+#include "core/application.hpp"
+#include "core/simulation.hpp"
+#include "core/spatial_tree.hpp"
+
+Application *Application::create_application() {
+    return new Application({"Collisions - Octree", 1280, 720});
+}
+
+// the 3D world is the 2D one extruded along z, viewed from the front
+const float world_half_depth = 360.f;
+
+static void init_particles_3d(std::vector<Particle3D>& particles, glm::vec3 min, glm::vec3 max) {
+    auto generator = std::default_random_engine(42);
+    std::uniform_real_distribution<float> unit_distribution(0.f, 1.f);
+    std::uniform_real_distribution<float> direction_distribution(-1.f, 1.f);
+    std::uniform_int_distribution<int> velocity_distribution(10, 20);
+    std::uniform_int_distribution<int> color_distribution(25, 100);
+    std::uniform_int_distribution<int> radius_distribution(min_radius, max_radius);
+
+    for (Particle3D& particle : particles) {
+        particle.radius = (float) radius_distribution(generator);
+
+        for (int d = 0; d < 3; d++) {
+            float lower = min[d] + particle.radius;
+            float upper = max[d] - particle.radius;
+            particle.position[d] = lower + (upper - lower) * unit_distribution(generator);
+        }
+
+        glm::vec3 direction = {direction_distribution(generator), direction_distribution(generator), direction_distribution(generator)};
+        particle.velocity = glm::normalize(direction + glm::vec3(1e-6f)) * (float) velocity_distribution(generator);
+
+        particle.color.x = (float) color_distribution(generator) / 100;
+        particle.color.y = (float) color_distribution(generator) / 100;
+        particle.color.z = (float) color_distribution(generator) / 100;
+    }
+}
+
+int main() {
+    Application::get();
+
+    unsigned circleVAO = initCircle({0.0f, 0.0f}, 1.f);
+
+    const World& world = Application::get()->get_world();
+    glm::vec3 world_min = {world.bounds.min.x, world.bounds.min.y, -world_half_depth};
+    glm::vec3 world_max = {world.bounds.max.x, world.bounds.max.y, world_half_depth};
+
+    std::vector<Particle3D> particles(particles_count);
+    init_particles_3d(particles, world_min, world_max);
+
+    // particles the octree can't hold (non finite positions), checked by every query
+    std::vector<Particle3D*> overflow;
+
+    Application::get()->register_system([&particles, &overflow, world_min, world_max]() {
+        // the root is grown to hold the particles that left the world, like QuadTreeIndex does
+        glm::vec3 min = world_min - (float) max_radius;
+        glm::vec3 max = world_max + (float) max_radius;
+        for (const Particle3D& particle : particles) {
+            glm::vec3 position = particle.position;
+            if (std::isfinite(position.x) && std::isfinite(position.y) && std::isfinite(position.z)) {
+                min = glm::min(min, position);
+                max = glm::max(max, position);
+            }
+        }
+
+        //create octree
+        Octree octree((min + max) / 2.f, (max - min) / 2.f);
+        overflow.clear();
+        for (Particle3D& particle : particles) {
+            if (!octree.insert(&particle)) {
+                overflow.push_back(&particle);
+            }
+        }
+
+        static bool warned = false;
+        if (!overflow.empty() && !warned) {
+            std::cout << "WARNING::OCTREE::PARTICLES_OUTSIDE_ROOT " << overflow.size() << std::endl;
+            warned = true;
+        }
+
+        //update physics
+        std::vector<Particle3D*> found;
+        for (Particle3D& particle : particles) {
+            found.clear();
+            octree.query(&particle, &found);
+
+            for (Particle3D* other : overflow) {
+                if (other != &particle) {
+                    found.push_back(other);
+                }
+            }
+
+            for (Particle3D* other : found) {
+                if (other > &particle && particle.intersect(*other)) {
+                    resolve_collision(particle, *other);
+                }
+            }
+        }
+
+        for (Particle3D& particle : particles) {
+            resolve_bounds(particle, world_min, world_max);
+
+            //update physic values
+            particle.position += particle.velocity * Application::delta_time;
+        }
+    });
+
+    Application::get()->register_system([&particles, circleVAO]() {
+        unsigned shader_program = Application::get()->get_shader_program();
+        int model_location = glGetUniformLocation(shader_program, "model");
+        int color_location = glGetUniformLocation(shader_program, "color");
+
+        glBindVertexArray(circleVAO);
+
+        //render particles, darker the further they are
+        for (Particle3D& particle : particles) {
+            float depth = (particle.position.z + world_half_depth) / (2.f * world_half_depth);
+            glm::vec3 color = particle.color * (1.f - 0.7f * depth);
+
+            glm::mat4 model          = glm::mat4(1.0f);
+            model       = glm::translate(model, glm::vec3(particle.position.x, particle.position.y, 0.0f));
+            model       = glm::scale(model, glm::vec3(particle.radius, particle.radius, 0.0f));
+
+            glUniformMatrix4fv(model_location, 1, GL_FALSE, &model[0][0]);
+            glUniform3fv(color_location, 1, &color[0]);
+            glDrawElements(GL_TRIANGLES, 90, GL_UNSIGNED_INT, nullptr);
+        }
+    });
+
+    Application::get()->run();
+
+    glDeleteVertexArrays(1, &circleVAO);
+
+    return 0;
+}
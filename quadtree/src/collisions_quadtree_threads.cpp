@@ -7,44 +7,117 @@
 
 #include "core/particle.hpp"
 #include "core/application.hpp"
-#include "core/quadtree.h"
+#include "core/snapshot.hpp"
+#include "core/recorder.hpp"
+#include "core/simulation.hpp"
+#include "core/spatial_index.hpp"
+#include "core/renderer.hpp"
+#include "core/numa.hpp"
 
 Application *Application::create_application() {
     return new Application({"Collisions - Quadtree - Threads", 1280, 720});
 }
 
-void update_physics(Particle* particles, const std::shared_ptr<QuadTree>& quad_tree, unsigned count, float deltaTime);
-
 int main(int argc, char const *argv[]) {
+    Options options = parse_options(argc, argv);
+
     Application::get();
 
-    unsigned circleVAO = initCircle({0.0f, 0.0f}, 10.f);
     unsigned quadVAO = initQuad({0.0f, 0.0f});
 
-    auto* particles = new Particle[particles_count];
-    init_particles(particles);
+    unsigned thread_count = std::thread::hardware_concurrency();
 
-    glm::vec2 screen_center = {0,0};
+    // the island solver runs its own unpinned threads over a single tree
+    if (options.numa && options.islands) {
+        std::cout << "WARNING::OPTIONS::NUMA_IGNORED the island solver doesn't pin its threads" << std::endl;
+        options.numa = false;
+    }
+
+    // with --numa every thread is pinned to a core, and its slice of the particles lives on its node
+    NumaTopology topology;
+    std::unique_ptr<NumaParticles> numa_particles;
+    Particle* particles;
+    if (options.numa) {
+        topology = options.numa_fake_nodes ? NumaTopology::fake(options.numa_fake_nodes) : NumaTopology::detect();
+        thread_count = topology.get_cpu_count();
+        numa_particles = std::make_unique<NumaParticles>(topology, particles_count, thread_count);
+        particles = numa_particles->data();
+        std::cout << "NUMA::TOPOLOGY " << topology.describe() << std::endl;
+    } else {
+        particles = new Particle[particles_count];
+    }
+
+    init_particles(particles, options);
+
+    if (numa_particles) {
+        std::cout << "NUMA::REMOTE_PAGES " << 100.f * numa_particles->remote_page_ratio() << "%" << std::endl;
+    }
+
+    if (!options.save_snapshot_path.empty()) {
+        Application::get()->register_system(snapshot_system(particles, particles_count, options.save_snapshot_path, options.snapshot_interval));
+    }
+
+    std::unique_ptr<TrajectoryRecorder> recorder;
+    if (!options.record_path.empty()) {
+        recorder = std::make_unique<TrajectoryRecorder>(options.record_path, particles_count);
+        Application::get()->register_system(recorder_system(recorder.get(), particles));
+    }
+
+    // with --numa one quadtree per node, so queries never walk a tree on another node
+    std::vector<QuadTreeIndex> indices(options.numa ? topology.get_node_count() : 1);
+    QuadTreeIndex& index = indices[0];
 
-    unsigned thread_count = std::thread::hardware_concurrency();
     auto* threads = new std::thread[thread_count];
 
-    Application::get()->register_system([particles, screen_center, quadVAO, threads, thread_count](){
-        float half_width = (float) Application::get()->get_window().get_width() / 2.f;
+    // with --numa the workers are pinned once, when they start, and reused every frame
+    std::unique_ptr<PinnedWorkers> workers;
+    if (numa_particles) {
+        workers = std::make_unique<PinnedWorkers>(topology, thread_count);
+    }
+
+    IslandSolver solver(options.sleep, thread_count);
+    if (options.islands) {
+        Application::get()->register_stats([&solver]() { return solver.describe(); });
+    }
+
+    Application::get()->register_system([particles, &index, &indices, &topology, &numa_particles, &workers, &solver, &options, quadVAO, threads, thread_count](){
+        const World& world = Application::get()->get_world();
+
         //create quadtree
-        std::shared_ptr<QuadTree> quad_tree = std::make_shared<QuadTree>(screen_center, half_width, 6);
+        if (workers) {
+            // built by the first worker of each node, so the tree nodes are allocated there
+            workers->run([particles, &indices, &topology, &world, thread_count](unsigned i) {
+                unsigned node = topology.node_of_thread(i, thread_count);
+                if (i == 0 || topology.node_of_thread(i - 1, thread_count) != node) {
+                    indices[node].build(particles, particles_count, world, Application::delta_time);
+                }
+            });
+        } else {
+            index.build(particles, particles_count, world, Application::delta_time);
+        }
 
-        for (unsigned i = 0; i < particles_count; i++) {
-            quad_tree->insert(&particles[i]);
+        index.draw(quadVAO, Application::get()->get_shader_program());
+
+        //update physics
+        if (options.islands) {
+            solver.step(index, particles, particles_count, world, Application::delta_time);
+            return;
         }
 
-        quad_tree->draw(quadVAO, Application::get()->get_shader_program());
+        if (workers) {
+            workers->run([particles, &indices, &topology, &numa_particles, &world, thread_count](unsigned i) {
+                QuadTreeIndex& node_index = indices[topology.node_of_thread(i, thread_count)];
+                update_physics(node_index, particles, numa_particles->begin(i), numa_particles->end(i), world, Application::delta_time);
+            });
+            return;
+        }
 
         unsigned thread_load = particles_count / thread_count;
 
-        //update physics
         for (unsigned i = 0; i < thread_count; i++) {
-            threads[i] = std::thread(update_physics, &particles[thread_load*i], quad_tree, thread_load, Application::delta_time);
+            unsigned begin = thread_load * i;
+            unsigned end = i + 1 == thread_count ? particles_count : begin + thread_load;
+            threads[i] = std::thread(update_physics<QuadTreeIndex>, std::ref(index), particles, begin, end, std::cref(world), Application::delta_time);
         }
 
         for (unsigned i = 0; i < thread_count; i++) {
@@ -53,100 +126,22 @@ int main(int argc, char const *argv[]) {
 
     });
 
-    Application::get()->register_system([circleVAO, particles]() {
+    ParticleRenderer renderer;
+
+    Application::get()->register_system([&renderer, &index]() {
         //render particles
-        for (unsigned i = 0; i < particles_count; i++)
-        {
-            glm::mat4 model          = glm::mat4(1.0f);
-            model       = glm::translate(model, glm::vec3(particles[i].position, 0.0f));
-            model       = glm::scale(model, glm::vec3(particles[i].radius, particles[i].radius, 0.0f));
-
-            glUniformMatrix4fv(glGetUniformLocation(Application::get()->get_shader_program(), "model"), 1, GL_FALSE, &model[0][0]);
-            glUniform3fv(glGetUniformLocation(Application::get()->get_shader_program(), "color"), 1, &particles[i].color[0]);
-            glBindVertexArray(circleVAO);
-            glDrawElements(GL_TRIANGLES, 90, GL_UNSIGNED_INT, nullptr);
-        }
+        renderer.draw(index);
     });
 
     Application::get()->run();
 
-    glDeleteVertexArrays(1, &circleVAO);
+    recorder.reset();
+
+    if (numa_particles) {
+        std::cout << "NUMA::REMOTE_PAGES " << 100.f * numa_particles->remote_page_ratio() << "%" << std::endl;
+    }
+
     glDeleteVertexArrays(1, &quadVAO);
 
     return 0;
 }
-
-void update_physics(Particle* particles, const std::shared_ptr<QuadTree>& quad_tree, unsigned count, float deltaTime)
-{
-    for (unsigned i = 0; i < count; i++)
-    {
-        Particle& particle = particles[i];
-        std::vector<Particle*> elements = {};
-
-        quad_tree->query(&particle, &elements);
-
-        for(Particle* other : elements)
-        {
-            if (particle.intersect(*other))
-            {
-                glm::vec2 distance = particle.position - other->position;
-                float magnitude = glm::length(distance);
-
-                glm::vec2 normal = glm::normalize(glm::vec2(other->position.x-particle.position.x, other->position.y-particle.position.y));
-
-                // apply force
-                float kx = (particle.velocity.x - other->velocity.x);
-                float ky = (particle.velocity.y - other->velocity.y);
-                float p = 2.0f * (normal.x * kx + normal.y * ky) / (particle.radius + other->radius);
-                particle.velocity.x = particle.velocity.x - p * other->radius * normal.x;
-                particle.velocity.y = particle.velocity.y - p * other->radius * normal.y;
-                other->velocity.x = other->velocity.x + p * particle.radius * normal.x;
-                other->velocity.y = other->velocity.y + p * particle.radius * normal.y;
-
-                // remove intersection
-                glm::vec2 forceDir = distance / magnitude;
-                glm::vec2 force = forceDir;
-                float intersectionLenght = particle.radius + other->radius - glm::length(particle.position - other->position);
-                glm::vec2 correction = force * intersectionLenght;
-
-                float max_distance = (particle.radius + other->radius);
-                particle.position += correction * particle.radius / max_distance;
-                other->position -= correction * other->radius / max_distance;
-            }
-        }
-
-        float half_width = (float) Application::get()->get_window().get_width() / 2.f;
-        float half_height = (float) Application::get()->get_window().get_height() / 2.f;
-
-        float maxX = half_width - particle.radius;
-        float minX = -maxX;
-
-        float maxY = half_height - particle.radius;
-        float minY = -maxY;
-
-        // screen bounds
-        if (particle.position.x <= minX)
-        {
-            particle.velocity.x = -particle.velocity.x;
-            particle.position.x = minX;
-        } else if (particle.position.x >= maxX ) {
-            particle.velocity.x = -particle.velocity.x;
-            particle.position.x = maxX;
-        }
-
-        if (particle.position.y <= minY)
-        {
-            particle.velocity.y = -particle.velocity.y;
-            particle.position.y = minY;
-        } else if (particle.position.y >= maxY)
-        {
-            particle.velocity.y = -particle.velocity.y;
-            particle.position.y = maxY;
-        }
-
-        //update physic values
-        particle.position += particle.velocity * deltaTime;
-
-        // particle.velocity *= 0.998f;
-    }
-}
\ No newline at end of file
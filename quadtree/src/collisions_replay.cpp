@@ -0,0 +1,87 @@
+// Plays back a trajectory recorded with --record, at the recorded pace.
+//
+//   collisions_replay --replay <file> [--scenario NAME] [--seed N] [--snapshot <file>]
+//
+// Trajectories only hold positions and velocities, radii and colors come from the usual initial
+// particles, so pass the scenario, seed or snapshot the recording started from.
+
+#include <vector>
+#include <memory>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "core/particle.hpp"
+#include "core/application.hpp"
+#include "core/recorder.hpp"
+#include "core/spatial_index.hpp"
+#include "core/renderer.hpp"
+
+Application *Application::create_application() {
+    return new Application({"Collisions - Replay", 1280, 720});
+}
+
+int main(int argc, char const *argv[]) {
+    Options options = parse_options(argc, argv);
+
+    if (options.replay_path.empty()) {
+        std::cout << "ERROR::REPLAY::NO_FILE usage: collisions_replay --replay <file>" << std::endl;
+        return 1;
+    }
+
+    TrajectoryReader reader(options.replay_path);
+    if (!reader.is_open()) {
+        return 1;
+    }
+
+    Application::get();
+
+    unsigned count = reader.get_header().particles_count;
+    if (count != particles_count) {
+        std::cout << "WARNING::REPLAY::COUNT_MISMATCH " << count << " recorded particles, radii and colors may not match" << std::endl;
+    }
+
+    std::vector<Particle> particles(count);
+    init_particles(particles.data(), count, options);
+
+    QuadTreeIndex index;
+    // frames missing from the file, dropped by the recorder when the disk couldn't keep up
+    unsigned missing_frames = 0;
+
+    Application::get()->register_system([&reader, &particles, &index, &missing_frames, count,
+                                         elapsed = 0.f, shown_time = 0.f, last_index = -1l, finished = false]() mutable {
+        elapsed += Application::delta_time;
+
+        // catch up with the recorded time, a gap in the frame indices keeps the previous frame on screen
+        TrajectoryFrameHeader frame = {};
+        while (!finished && shown_time <= elapsed) {
+            if (!reader.next_frame(particles.data(), &frame)) {
+                finished = true;
+                break;
+            }
+
+            if (last_index >= 0 && (long) frame.index > last_index + 1) {
+                missing_frames += (unsigned) (frame.index - last_index - 1);
+            }
+            last_index = frame.index;
+            shown_time = frame.time;
+        }
+
+        index.build(particles.data(), count, Application::get()->get_world(), Application::delta_time);
+    });
+
+    ParticleRenderer renderer;
+
+    Application::get()->register_system([&renderer, &index]() {
+        //render particles
+        renderer.draw(index);
+    });
+
+    Application::get()->run();
+
+    if (missing_frames) {
+        std::cout << "WARNING::REPLAY::MISSING_FRAMES " << missing_frames << std::endl;
+    }
+
+    return 0;
+}
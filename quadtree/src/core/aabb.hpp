@@ -0,0 +1,26 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+struct AABB {
+    glm::vec2 min;
+    glm::vec2 max;
+
+    static AABB from_center(glm::vec2 center, glm::vec2 half_size) {
+        return {center - half_size, center + half_size};
+    }
+
+    bool contains(glm::vec2 point) const {
+        return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y;
+    }
+
+    bool intersects(const AABB& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y && max.y >= other.min.y;
+    }
+
+    // squared distance from point to the closest point of the box, 0 when inside
+    float distance2(glm::vec2 point) const {
+        glm::vec2 delta = glm::max(glm::max(min - point, point - max), glm::vec2(0.f));
+        return glm::dot(delta, delta);
+    }
+};
@@ -0,0 +1,43 @@
+#include "activity.hpp"
+
+#include <limits>
+
+ActivityTracker::ActivityTracker(const SleepThresholds& thresholds) : m_thresholds(thresholds) {
+    // still steps are counted on 16 bits
+    m_thresholds.steps = glm::clamp(m_thresholds.steps, 1u, (unsigned) std::numeric_limits<uint16_t>::max());
+}
+
+void ActivityTracker::resize(unsigned count) {
+    if (m_asleep.size() == count) {
+        return;
+    }
+
+    m_still_steps.assign(count, 0);
+    m_asleep.assign(count, 0);
+    m_impulses.assign(count, 0.f);
+    m_sleeping_count = 0;
+}
+
+void ActivityTracker::update(Particle* particles, unsigned count) {
+    m_sleeping_count = 0;
+
+    for (unsigned i = 0; i < count; i++) {
+        if (m_asleep[i]) {
+            m_sleeping_count++;
+            continue;
+        }
+
+        Particle& particle = particles[i];
+        bool still = glm::dot(particle.velocity, particle.velocity) < m_thresholds.velocity * m_thresholds.velocity &&
+                     m_impulses[i] < m_thresholds.impulse;
+
+        m_still_steps[i] = still ? (uint16_t) (m_still_steps[i] + 1) : 0;
+        m_impulses[i] = 0.f;
+
+        if (m_still_steps[i] >= m_thresholds.steps) {
+            m_asleep[i] = 1;
+            particle.velocity = {0.f, 0.f};
+            m_sleeping_count++;
+        }
+    }
+}
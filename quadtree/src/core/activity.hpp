@@ -0,0 +1,44 @@
+#ifndef SPATIAL_DATA_PARTITIONING_ACTIVITY_HPP
+#define SPATIAL_DATA_PARTITIONING_ACTIVITY_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "particle.hpp"
+
+struct SleepThresholds {
+    // a particle is still when its speed and the impulses it received in a step stay under these
+    float velocity = 0.5f;
+    float impulse = 0.5f;
+    // steps a particle must stay still before it falls asleep
+    unsigned steps = 60;
+};
+
+// Tracks which particles settled down. Sleeping particles are skipped by the broad-phase and the
+// solver until an awake particle touches them.
+class ActivityTracker {
+public:
+    explicit ActivityTracker(const SleepThresholds& thresholds = {});
+
+    void resize(unsigned count);
+
+    bool is_asleep(unsigned i) const { return m_asleep[i] != 0; }
+    void wake(unsigned i) { m_asleep[i] = 0; m_still_steps[i] = 0; }
+    // impulses of a particle are only recorded by the thread solving its island
+    void record_impulse(unsigned i, float magnitude) { m_impulses[i] += magnitude; }
+
+    // ends a step: counts still steps, puts the particles still for long enough to sleep and clears the impulses
+    void update(Particle* particles, unsigned count);
+
+    unsigned get_sleeping_count() const { return m_sleeping_count; }
+    const SleepThresholds& get_thresholds() const { return m_thresholds; }
+
+private:
+    SleepThresholds m_thresholds;
+    std::vector<uint16_t> m_still_steps;
+    std::vector<uint8_t> m_asleep;
+    std::vector<float> m_impulses;
+    unsigned m_sleeping_count = 0;
+};
+
+#endif //SPATIAL_DATA_PARTITIONING_ACTIVITY_HPP
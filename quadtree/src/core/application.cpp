@@ -15,6 +15,9 @@
 float Application::delta_time = 0.0f;
 
 Application::Application(WindowData data): window(data), systems(0) {
+    // the world keeps the initial window size
+    world.bounds = AABB::from_center({0.f, 0.f}, {(float) data.width / 2.f, (float) data.height / 2.f});
+
     //Initialize shaders
     GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
     glShaderSource(vertexShader, 1, &vertexSource, nullptr);
@@ -44,13 +47,21 @@ Application::Application(WindowData data): window(data), systems(0) {
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
 
-    glm::mat4 projection = glm::mat4(1.0f);
+    update_projection();
+}
+
+AABB Application::get_viewport() {
+    glm::vec2 half_size = {(float) window.get_width() / 2.f, (float) window.get_height() / 2.f};
 
-    float half_width = (float) data.width / 2.f;
-    float half_height = (float) data.height / 2.f;
+    return AABB::from_center({0.f, 0.f}, half_size / window.get_zoom());
+}
+
+void Application::update_projection() {
+    AABB viewport = get_viewport();
 
-    projection = glm::ortho(-half_width, half_width, -half_height, half_height,-1000.0f, 1000.0f);
+    glm::mat4 projection = glm::ortho(viewport.min.x, viewport.max.x, viewport.min.y, viewport.max.y, -1000.0f, 1000.0f);
 
+    glUseProgram(shader_program);
     glUniformMatrix4fv(glGetUniformLocation(shader_program, "projection"), 1, GL_FALSE, &projection[0][0]);
 }
 
@@ -61,6 +72,7 @@ void Application::run() {
     {
         glClear(GL_COLOR_BUFFER_BIT);
         glfwPollEvents();
+        update_projection();
         for (auto& system : systems) {
             system();
         }
@@ -78,6 +90,9 @@ void Application::run() {
             std::stringstream fmt;
 
             fmt <<  window.get_title() << " - FPS: " << framesPerSecond << " - Particles count: " << particles_count;
+            for (auto& stat : stats) {
+                fmt << " - " << stat();
+            }
 
             glfwSetWindowTitle(window.get_native_window(), fmt.str().c_str());
             frameTimeAccumulator = 0;
@@ -6,15 +6,23 @@
 #define SPATIAL_DATA_PARTITIONING_APPLICATION_HPP
 
 #include "window.hpp"
+#include "aabb.hpp"
+#include "world.hpp"
 
 #include <functional>
+#include <string>
 
 class Application {
 public:
     void run();
     Window& get_window() { return window; }
+    const World& get_world() const { return world; }
     void register_system(std::function<void()> system) { systems.push_back(system); }
+    // appended to the FPS and particles count shown in the title, once per second
+    void register_stats(std::function<std::string()> stat) { stats.push_back(stat); }
     unsigned get_shader_program() { return shader_program; }
+    // world region currently on screen
+    AABB get_viewport();
 
     static Application* get() {
         static Application* instance = create_application();
@@ -28,8 +36,12 @@ protected:
     explicit Application(WindowData data);
     ~Application() = default;
 private:
+    void update_projection();
+
     Window window;
+    World world;
     std::vector<std::function<void()>> systems;
+    std::vector<std::function<std::string()>> stats;
     unsigned shader_program;
 };
 
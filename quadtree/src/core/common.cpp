@@ -1,53 +1,49 @@
+#include "snapshot.hpp"
+#include "scenarios.hpp"
+
 void init_particles(Particle* particles) {
-    int half_width = Application::get()->get_window().get_width() / 2;
-    int half_height = Application::get()->get_window().get_height() / 2;
-
-    long* seed = new long();
-    auto generator = std::default_random_engine((long) seed);
-    std::uniform_int_distribution<int> x_distribution(-(half_width-max_radius),half_width-max_radius);
-    std::uniform_int_distribution<int> y_distribution(-(half_height-max_radius), half_height-max_radius);
-    std::uniform_int_distribution<int> velocity_distribution(10, 20);
-    std::uniform_int_distribution<int> color_distribution(25, 100);
-    std::uniform_int_distribution<int> radius_distribution(min_radius, max_radius);
-
-    for (unsigned i = 0; i < particles_count; i++)
-    {
-        Particle& particle = particles[i];
-        particle.position.x = (float) x_distribution(generator);
-        particle.position.y = (float) y_distribution(generator);
-
-        particle.velocity = (particle.position / glm::length(particle.position)) * (float) velocity_distribution(generator);
-
-        particle.radius = (float) radius_distribution(generator);
-
-        particle.color.x = (float) color_distribution(generator) / 100;
-        particle.color.y = (float) color_distribution(generator) / 100;
-        particle.color.z = (float) color_distribution(generator) / 100;
+    init_particles(particles, Options());
+}
+
+void init_particles(Particle* particles, const Options& options) {
+    init_particles(particles, particles_count, options);
+}
+
+void init_particles(Particle* particles, unsigned count, const Options& options) {
+    if (!options.snapshot_path.empty() && load_snapshot(options.snapshot_path, particles, count)) {
+        return;
     }
+
+    const Scenario* scenario = find_scenario(options.scenario);
+    if (!scenario) {
+        std::cout << "ERROR::SCENARIO::UNKNOWN " << options.scenario << std::endl;
+        scenario = find_scenario("uniform");
+    }
+
+    generate_particles(*scenario, particles, count, Application::get()->get_world().bounds, (float) max_radius, options.seed);
 }
 
-unsigned initCircle(glm::vec2 point, float radius) {
-    std::vector<glm::vec2> vertices = std::vector<glm::vec2>(32);
+unsigned initCircle(glm::vec2 point, float radius, unsigned segments) {
+    // center followed by segments + 1 points around it, the last one closing the fan
+    std::vector<glm::vec2> vertices = std::vector<glm::vec2>(segments + 2);
 
     vertices[0] = point;
 
 
-    for (unsigned i = 1; i < 32; i++) {
-        float angle = (360.f/30.f) * (float) (i - 1);
+    for (unsigned i = 1; i < segments + 2; i++) {
+        float angle = (360.f/(float) segments) * (float) (i - 1);
         glm::vec2 vertice = {glm::cos(glm::radians(angle)), glm::sin(glm::radians(angle))};
         vertices[i] = vertice;
     }
 
-    std::vector<unsigned > indices = std::vector<unsigned >(96);
+    std::vector<unsigned > indices = std::vector<unsigned >(segments * 3);
 
-    for(unsigned i = 0; i < 32; i++) {
+    for(unsigned i = 0; i < segments; i++) {
         indices[0+(i*3)] = 0;
         indices[1+(i*3)] = i+1;
         indices[2+(i*3)] = i+2;
     }
 
-    //indices[89] = 1;
-
     unsigned VBO, VAO, EBO;
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
@@ -4,11 +4,17 @@
 #include <glad/glad.h>
 #include "particle.hpp"
 #include "application.hpp"
+#include "options.hpp"
 
 const unsigned particles_count = 15000;
 const int max_radius = 3;
 const int min_radius = 3;
 
+// the default scenario and seed
 void init_particles(Particle* particles);
-unsigned initCircle(glm::vec2 point, float radius);
+// loads options.snapshot_path when given, otherwise generates options.scenario from options.seed
+void init_particles(Particle* particles, const Options& options);
+// same for count particles instead of particles_count, a snapshot must hold count particles
+void init_particles(Particle* particles, unsigned count, const Options& options);
+unsigned initCircle(glm::vec2 point, float radius, unsigned segments = 30);
 unsigned initQuad(glm::vec2 point);
\ No newline at end of file
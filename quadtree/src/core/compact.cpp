@@ -0,0 +1,344 @@
+#include "compact.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simulation.hpp"
+
+// fixed point steps: 1/65536 of a cell for positions, 1/32 px/s for velocities (up to 1024 px/s)
+// and 1/16 px for radii (up to 15.9 px)
+const float position_scale = 65536.f;
+const float velocity_scale = 32.f;
+const float radius_scale = 16.f;
+
+// as in QuadTree, leaves smaller than this chain extra records instead of subdividing
+const float min_half_size = 1e-3f;
+// steps between two sorts of the particles by cell
+const unsigned sort_interval = 32;
+
+template<typename T>
+static T quantize(float value, float scale)
+{
+    float limit_min = (float) std::numeric_limits<T>::min();
+    float limit_max = (float) std::numeric_limits<T>::max();
+
+    return (T) std::lround(glm::clamp(value * scale, limit_min, limit_max));
+}
+
+static uint16_t pack_color(glm::vec3 color)
+{
+    glm::vec3 c = glm::clamp(color, glm::vec3(0.f), glm::vec3(1.f));
+
+    return (uint16_t) ((std::lround(c.x * 31.f) << 11) | (std::lround(c.y * 63.f) << 5) | std::lround(c.z * 31.f));
+}
+
+static glm::vec3 unpack_color(uint16_t color)
+{
+    return {(float) (color >> 11) / 31.f, (float) ((color >> 5) & 63) / 63.f, (float) (color & 31) / 31.f};
+}
+
+CompactGrid::CompactGrid(const AABB& bounds, float cell_size)
+{
+    glm::vec2 size = bounds.max - bounds.min;
+
+    m_bounds = bounds;
+    m_cell_size = cell_size;
+    m_columns = (uint32_t) glm::max(1.f, std::ceil(size.x / cell_size));
+    m_rows = (uint32_t) glm::max(1.f, std::ceil(size.y / cell_size));
+}
+
+void CompactGrid::encode(const Particle& particle, CompactParticle& compact) const
+{
+    // positions outside the grid are clamped to its border
+    glm::vec2 local = (particle.position - m_bounds.min) / m_cell_size;
+    float column = glm::clamp(std::floor(local.x), 0.f, (float) (m_columns - 1));
+    float row = glm::clamp(std::floor(local.y), 0.f, (float) (m_rows - 1));
+
+    compact.cell = (uint32_t) row * m_columns + (uint32_t) column;
+    compact.x = (uint16_t) glm::clamp(std::lround((local.x - column) * position_scale), 0l, 65535l);
+    compact.y = (uint16_t) glm::clamp(std::lround((local.y - row) * position_scale), 0l, 65535l);
+    compact.velocity_x = quantize<int16_t>(particle.velocity.x, velocity_scale);
+    compact.velocity_y = quantize<int16_t>(particle.velocity.y, velocity_scale);
+    compact.radius = quantize<uint8_t>(particle.radius, radius_scale);
+}
+
+AABB CompactGrid::extent() const
+{
+    return {m_bounds.min, m_bounds.min + glm::vec2(m_columns, m_rows) * m_cell_size};
+}
+
+glm::vec2 CompactGrid::decode_position(const CompactParticle& compact) const
+{
+    glm::vec2 cell = {(float) (compact.cell % m_columns), (float) (compact.cell / m_columns)};
+    glm::vec2 offset = glm::vec2(compact.x, compact.y) / position_scale;
+
+    return m_bounds.min + (cell + offset) * m_cell_size;
+}
+
+void CompactGrid::decode(const CompactParticle& compact, Particle& particle) const
+{
+    particle.position = decode_position(compact);
+    particle.velocity = glm::vec2(compact.velocity_x, compact.velocity_y) / velocity_scale;
+    particle.radius = (float) compact.radius / radius_scale;
+}
+
+void CompactGrid::pack(const Particle& particle, CompactParticle& compact) const
+{
+    encode(particle, compact);
+    compact.color = pack_color(particle.color);
+    compact.padding = 0;
+}
+
+void CompactGrid::unpack(const CompactParticle& compact, Particle& particle) const
+{
+    decode(compact, particle);
+    particle.color = unpack_color(compact.color);
+}
+
+void CompactQuadTree::build(const CompactParticle* particles, unsigned count, const CompactGrid& grid)
+{
+    // the last row and column of cells reach past the grid bounds, so does the root
+    AABB bounds = grid.extent();
+
+    m_nodes.clear();
+    m_max_radius = 0.f;
+    m_center = (bounds.min + bounds.max) / 2.f;
+    m_half_size = (bounds.max - bounds.min) / 2.f;
+    allocate();
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        m_max_radius = glm::max(m_max_radius, (float) particles[i].radius / radius_scale);
+        insert(i, grid.decode_position(particles[i]));
+    }
+
+    // the array grows by doubling, give the slack of the first builds back while keeping some
+    // headroom for the node count to vary between steps
+    size_t size = m_nodes.size();
+    if (m_nodes.capacity() > size + size / 4)
+    {
+        std::vector<CompactNode> nodes;
+        nodes.reserve(size + size / 8);
+        nodes.assign(m_nodes.begin(), m_nodes.end());
+        m_nodes.swap(nodes);
+    }
+}
+
+uint32_t CompactQuadTree::allocate()
+{
+    m_nodes.push_back({});
+
+    return (uint32_t) m_nodes.size() - 1;
+}
+
+void CompactQuadTree::insert(uint32_t element, glm::vec2 position)
+{
+    // decoded positions lie inside the root, clamping keeps rounding at its border from filing an
+    // element under a child that doesn't contain it
+    position = glm::clamp(position, m_center - m_half_size, m_center + m_half_size);
+
+    uint32_t index = 0;
+    glm::vec2 center = m_center;
+    glm::vec2 half_size = m_half_size;
+
+    while (true)
+    {
+        CompactNode& node = m_nodes[index];
+
+        if (node.count < compact_node_capacity)
+        {
+            node.elements[node.count++] = element;
+            return;
+        }
+
+        if (node.first_child == 0)
+        {
+            if (glm::max(half_size.x, half_size.y) < min_half_size)
+            {
+                if (node.next == 0)
+                {
+                    uint32_t next = allocate();
+                    m_nodes[index].next = next;
+                }
+                index = m_nodes[index].next;
+                continue;
+            }
+
+            // allocate may move the nodes, don't use node past this point
+            uint32_t first_child = allocate();
+            allocate();
+            allocate();
+            allocate();
+            m_nodes[index].first_child = first_child;
+        }
+
+        // children order: top left, top right, bottom left, bottom right
+        glm::vec2 side = {position.x >= center.x ? 1.f : -1.f, position.y >= center.y ? 1.f : -1.f};
+        uint32_t quadrant = (side.x > 0.f ? 1u : 0u) | (side.y > 0.f ? 2u : 0u);
+
+        half_size /= 2.f;
+        center += side * half_size;
+        index = m_nodes[index].first_child + quadrant;
+    }
+}
+
+void CompactQuadTree::query(glm::vec2 position, float radius, std::vector<uint32_t>* found) const
+{
+    if (!m_nodes.empty())
+    {
+        query(0, m_center, m_half_size, position, radius + m_max_radius, found);
+    }
+}
+
+void CompactQuadTree::query(uint32_t index, glm::vec2 center, glm::vec2 half_size, glm::vec2 position, float reach, std::vector<uint32_t>* found) const
+{
+    glm::vec2 distance = glm::abs(position - center);
+
+    if (distance.x > half_size.x + reach || distance.y > half_size.y + reach)
+    {
+        return;
+    }
+
+    const CompactNode& node = m_nodes[index];
+    for (uint32_t record = index; ; record = m_nodes[record].next)
+    {
+        const CompactNode& elements = m_nodes[record];
+        found->insert(found->end(), elements.elements, elements.elements + elements.count);
+
+        if (elements.next == 0)
+        {
+            break;
+        }
+    }
+
+    if (node.first_child)
+    {
+        glm::vec2 child_half_size = half_size / 2.f;
+
+        query(node.first_child, center + glm::vec2(-child_half_size.x, -child_half_size.y), child_half_size, position, reach, found);
+        query(node.first_child + 1, center + glm::vec2(child_half_size.x, -child_half_size.y), child_half_size, position, reach, found);
+        query(node.first_child + 2, center + glm::vec2(-child_half_size.x, child_half_size.y), child_half_size, position, reach, found);
+        query(node.first_child + 3, center + child_half_size, child_half_size, position, reach, found);
+    }
+}
+
+CompactSimulation::CompactSimulation(const World& world, float cell_size)
+{
+    m_world = world;
+    m_cell_size = cell_size;
+}
+
+void CompactSimulation::assign(const Particle* particles, unsigned count)
+{
+    // a margin so particles slightly past the walls before bouncing back aren't clamped
+    float margin = 0.f;
+    for (unsigned i = 0; i < count; i++)
+    {
+        margin = glm::max(margin, 2.f * particles[i].radius);
+    }
+    m_grid = CompactGrid({m_world.bounds.min - margin, m_world.bounds.max + margin}, m_cell_size);
+
+    m_particles.resize(count);
+    for (unsigned i = 0; i < count; i++)
+    {
+        m_grid.pack(particles[i], m_particles[i]);
+    }
+    m_steps = 0;
+}
+
+void CompactSimulation::unpack(Particle* particles) const
+{
+    for (size_t i = 0; i < m_particles.size(); i++)
+    {
+        m_grid.unpack(m_particles[i], particles[i]);
+    }
+}
+
+void CompactSimulation::sort_by_cell()
+{
+    std::sort(m_particles.begin(), m_particles.end(), [](const CompactParticle& a, const CompactParticle& b) {
+        return a.cell < b.cell;
+    });
+}
+
+void CompactSimulation::step(float delta_time)
+{
+    if (m_steps++ % sort_interval == 0)
+    {
+        sort_by_cell();
+    }
+
+    uint32_t count = get_count();
+    m_tree.build(m_particles.data(), count, m_grid);
+
+    //update physics
+    Particle particle = {};
+    Particle other = {};
+    for (uint32_t i = 0; i < count; i++)
+    {
+        m_grid.decode(m_particles[i], particle);
+
+        m_found.clear();
+        m_tree.query(particle.position, particle.radius, &m_found);
+
+        // only write back what collided, so resting particles don't pick up rounding errors
+        bool collided = false;
+        for (uint32_t j : m_found)
+        {
+            if (j <= i)
+            {
+                continue;
+            }
+
+            m_grid.decode(m_particles[j], other);
+            if (particle.intersect(other))
+            {
+                resolve_collision(particle, other);
+                m_grid.encode(other, m_particles[j]);
+                collided = true;
+            }
+        }
+
+        if (collided)
+        {
+            m_grid.encode(particle, m_particles[i]);
+        }
+    }
+
+    for (CompactParticle& compact : m_particles)
+    {
+        m_grid.decode(compact, particle);
+
+        resolve_bounds(particle, m_world.bounds);
+
+        //update physic values
+        particle.position += particle.velocity * delta_time;
+
+        m_grid.encode(particle, compact);
+    }
+}
+
+void CompactSimulation::find_pairs(std::vector<std::pair<uint32_t, uint32_t>>* pairs)
+{
+    uint32_t count = get_count();
+    m_tree.build(m_particles.data(), count, m_grid);
+
+    Particle particle = {};
+    Particle other = {};
+    for (uint32_t i = 0; i < count; i++)
+    {
+        m_grid.decode(m_particles[i], particle);
+
+        m_found.clear();
+        m_tree.query(particle.position, particle.radius, &m_found);
+
+        for (uint32_t j : m_found)
+        {
+            m_grid.decode(m_particles[j], other);
+            if (j > i && particle.intersect(other))
+            {
+                pairs->emplace_back(i, j);
+            }
+        }
+    }
+}
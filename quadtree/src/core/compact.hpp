@@ -0,0 +1,120 @@
+#ifndef SPATIAL_DATA_PARTITIONING_COMPACT_HPP
+#define SPATIAL_DATA_PARTITIONING_COMPACT_HPP
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "particle.hpp"
+#include "aabb.hpp"
+#include "world.hpp"
+
+// Compact mode, for runs with millions of particles where memory bandwidth bounds the step.
+// A particle takes 16 bytes instead of 32: its position is a 16 bits fixed point offset inside a
+// cell of a uniform grid, velocity and radius are fixed point too and the color is RGB565.
+// Tree nodes are 64 bytes records in one array, linked by 32 bits indices.
+struct CompactParticle {
+    uint32_t cell;
+    uint16_t x;
+    uint16_t y;
+    int16_t velocity_x;
+    int16_t velocity_y;
+    uint16_t color;
+    uint8_t radius;
+    uint8_t padding;
+};
+
+static_assert(sizeof(CompactParticle) == 16, "CompactParticle must stay 16 bytes");
+
+// grid the compact positions are relative to
+class CompactGrid {
+public:
+    CompactGrid() = default;
+    CompactGrid(const AABB& bounds, float cell_size);
+
+    void encode(const Particle& particle, CompactParticle& compact) const;
+    // position, velocity and radius, color is only decoded by unpack
+    void decode(const CompactParticle& compact, Particle& particle) const;
+    glm::vec2 decode_position(const CompactParticle& compact) const;
+    // encode and decode, color included
+    void pack(const Particle& particle, CompactParticle& compact) const;
+    void unpack(const CompactParticle& compact, Particle& particle) const;
+
+    const AABB& bounds() const { return m_bounds; }
+    // area covered by the cells, whole cells so a bit past bounds, every decoded position lies inside
+    AABB extent() const;
+
+private:
+    AABB m_bounds = {};
+    float m_cell_size = 1.f;
+    uint32_t m_columns = 1;
+    uint32_t m_rows = 1;
+};
+
+// number of particle indices fitting in a 64 bytes node
+const unsigned compact_node_capacity = 13;
+
+// nodes don't store their bounds, they are computed from the root's while going down the tree
+struct alignas(64) CompactNode {
+    // the four children are stored together from first_child, 0 for a leaf (the root is never a child)
+    uint32_t first_child;
+    // record holding more elements of a leaf too small to subdivide, 0 for none
+    uint32_t next;
+    uint32_t count;
+    uint32_t elements[compact_node_capacity];
+};
+
+static_assert(sizeof(CompactNode) == 64, "CompactNode must fill one cache line");
+
+// QuadTree over CompactParticle indices, rebuilt from scratch each step into the same node array.
+class CompactQuadTree {
+public:
+    void build(const CompactParticle* particles, unsigned count, const CompactGrid& grid);
+    // indices of the particles that may touch a particle of radius at position, itself included
+    void query(glm::vec2 position, float radius, std::vector<uint32_t>* found) const;
+
+    size_t memory() const { return m_nodes.capacity() * sizeof(CompactNode); }
+    unsigned get_node_count() const { return (unsigned) m_nodes.size(); }
+
+private:
+    uint32_t allocate();
+    void insert(uint32_t element, glm::vec2 position);
+    void query(uint32_t index, glm::vec2 center, glm::vec2 half_size, glm::vec2 position, float reach, std::vector<uint32_t>* found) const;
+
+    std::vector<CompactNode> m_nodes;
+    glm::vec2 m_center = {};
+    glm::vec2 m_half_size = {};
+    float m_max_radius = 0.f;
+};
+
+// Steps particles stored compact, the same physics as update_physics with a quadtree.
+// Particles are periodically sorted by cell to keep neighbours close in memory, so their order changes.
+class CompactSimulation {
+public:
+    explicit CompactSimulation(const World& world, float cell_size = 64.f);
+
+    void assign(const Particle* particles, unsigned count);
+    void unpack(Particle* particles) const;
+    void step(float delta_time);
+    // intersecting pairs (i < j) the next step would start from, in the current particle order
+    void find_pairs(std::vector<std::pair<uint32_t, uint32_t>>* pairs);
+
+    unsigned get_count() const { return (unsigned) m_particles.size(); }
+    size_t memory() const { return m_particles.capacity() * sizeof(CompactParticle) + m_tree.memory(); }
+
+private:
+    void sort_by_cell();
+
+    World m_world;
+    float m_cell_size;
+    CompactGrid m_grid;
+    std::vector<CompactParticle> m_particles;
+    CompactQuadTree m_tree;
+    std::vector<uint32_t> m_found;
+    unsigned m_steps = 0;
+};
+
+#endif //SPATIAL_DATA_PARTITIONING_COMPACT_HPP
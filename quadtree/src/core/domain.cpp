@@ -0,0 +1,325 @@
+#include "domain.hpp"
+#include "quadtree.h"
+#include "simulation.hpp"
+
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+enum Side { Left = 0, Right = 1 };
+
+struct OutboxHeader {
+    unsigned ghost_count;
+    unsigned migrant_count;
+};
+
+// Shared mapping layout: barrier, stats of every domain, then two outboxes (left, right) per domain,
+// each one an OutboxHeader followed by `capacity` ghosts and `capacity` migrants.
+class DomainExchange {
+public:
+    DomainExchange(unsigned domains, unsigned capacity) : m_domains(domains), m_capacity(capacity) {
+        m_stats_offset = align(sizeof(pthread_barrier_t));
+        m_outboxes_offset = align(m_stats_offset + sizeof(DomainStats) * domains);
+        m_outbox_size = align(sizeof(OutboxHeader) + sizeof(Particle) * capacity * 2);
+        m_size = m_outboxes_offset + m_outbox_size * domains * 2;
+
+        // shared anonymous memory is inherited by the forked domain processes, and zero filled
+        void* data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) {
+            std::cout << "ERROR::DOMAIN::SHARED_MEMORY_FAILED" << std::endl;
+            return;
+        }
+        m_data = (unsigned char*) data;
+
+        pthread_barrierattr_t attributes;
+        pthread_barrierattr_init(&attributes);
+        pthread_barrierattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+        pthread_barrier_init(barrier(), &attributes, domains);
+        pthread_barrierattr_destroy(&attributes);
+    }
+
+    ~DomainExchange() {
+        if (m_data) {
+            pthread_barrier_destroy(barrier());
+            munmap(m_data, m_size);
+        }
+    }
+
+    DomainExchange(const DomainExchange&) = delete;
+    DomainExchange& operator=(const DomainExchange&) = delete;
+
+    bool is_valid() const { return m_data != nullptr; }
+    unsigned get_capacity() const { return m_capacity; }
+
+    void wait() { pthread_barrier_wait(barrier()); }
+
+    DomainStats& stats(unsigned domain) {
+        return ((DomainStats*) (m_data + m_stats_offset))[domain];
+    }
+
+    OutboxHeader& outbox(unsigned domain, Side side) {
+        return *(OutboxHeader*) outbox_data(domain, side);
+    }
+
+    Particle* ghosts(unsigned domain, Side side) {
+        return (Particle*) (outbox_data(domain, side) + sizeof(OutboxHeader));
+    }
+
+    Particle* migrants(unsigned domain, Side side) {
+        return ghosts(domain, side) + m_capacity;
+    }
+
+private:
+    static size_t align(size_t size) { return (size + 63) / 64 * 64; }
+
+    pthread_barrier_t* barrier() { return (pthread_barrier_t*) m_data; }
+
+    unsigned char* outbox_data(unsigned domain, Side side) {
+        return m_data + m_outboxes_offset + m_outbox_size * (domain * 2 + side);
+    }
+
+    unsigned m_domains;
+    unsigned m_capacity;
+    size_t m_stats_offset;
+    size_t m_outboxes_offset;
+    size_t m_outbox_size;
+    size_t m_size = 0;
+    unsigned char* m_data = nullptr;
+};
+
+static AABB domain_strip(const DomainConfig& config, unsigned domain) {
+    float width = (config.world.max.x - config.world.min.x) / (float) config.domains;
+    float min_x = config.world.min.x + width * (float) domain;
+
+    return {{min_x, config.world.min.y}, {min_x + width, config.world.max.y}};
+}
+
+static void collide(std::vector<Particle>& particles, unsigned own_count, const AABB& strip, float ghost_width, DomainStats& stats) {
+    // particles past the strip borders are either ghosts or migrants not yet handed over
+    glm::vec2 center = (strip.min + strip.max) / 2.f;
+    glm::vec2 half_size = (strip.max - strip.min) / 2.f + ghost_width * 2.f;
+    QuadTree tree(center, half_size, 6);
+
+    for (Particle& particle : particles) {
+        tree.insert(&particle);
+    }
+
+    std::vector<Particle*> found;
+    for (unsigned i = 0; i < own_count; i++) {
+        Particle& particle = particles[i];
+
+        found.clear();
+        tree.query(&particle, &found);
+
+        for (Particle* other : found) {
+            if (!particle.intersect(*other)) {
+                continue;
+            }
+
+            if (other < &particles[own_count]) {
+                if (other > &particle) {
+                    resolve_collision(particle, *other);
+                    stats.contacts++;
+                }
+            } else {
+                // the neighbor owning the ghost applies its own half of the contact
+                Particle ghost = *other;
+                resolve_collision(particle, ghost);
+                (ghost.position.x < center.x ? stats.left_contacts : stats.right_contacts)++;
+            }
+        }
+    }
+}
+
+static void run_domain(DomainExchange& exchange, const DomainConfig& config, unsigned domain, std::vector<Particle> particles) {
+    AABB strip = domain_strip(config, domain);
+    bool has_left = domain > 0;
+    bool has_right = domain + 1 < config.domains;
+    unsigned capacity = exchange.get_capacity();
+
+    DomainStats stats = {};
+    auto start = std::chrono::steady_clock::now();
+
+    for (unsigned step = 0; step < config.steps; step++) {
+        // the migrants of the previous step are published
+        exchange.wait();
+
+        // receive migrants first, a particle that just crossed a border must be among the ghosts
+        // its new owner publishes, or its contacts across the border would only be resolved on one side
+        for (unsigned neighbor_side = Left; neighbor_side <= Right; neighbor_side++) {
+            bool exists = neighbor_side == Left ? has_left : has_right;
+            if (!exists) {
+                continue;
+            }
+
+            unsigned neighbor = neighbor_side == Left ? domain - 1 : domain + 1;
+            Side towards_us = neighbor_side == Left ? Right : Left;
+            OutboxHeader& outbox = exchange.outbox(neighbor, towards_us);
+            Particle* migrants = exchange.migrants(neighbor, towards_us);
+
+            particles.insert(particles.end(), migrants, migrants + outbox.migrant_count);
+        }
+
+        // publish ghosts
+        OutboxHeader& left = exchange.outbox(domain, Left);
+        OutboxHeader& right = exchange.outbox(domain, Right);
+        left.ghost_count = 0;
+        right.ghost_count = 0;
+
+        for (const Particle& particle : particles) {
+            if (has_left && particle.position.x < strip.min.x + config.ghost_width) {
+                if (left.ghost_count < capacity) {
+                    exchange.ghosts(domain, Left)[left.ghost_count++] = particle;
+                } else {
+                    stats.overflows++;
+                }
+            }
+
+            if (has_right && particle.position.x > strip.max.x - config.ghost_width) {
+                if (right.ghost_count < capacity) {
+                    exchange.ghosts(domain, Right)[right.ghost_count++] = particle;
+                } else {
+                    stats.overflows++;
+                }
+            }
+        }
+
+        exchange.wait();
+
+        auto own_count = (unsigned) particles.size();
+
+        for (unsigned neighbor_side = Left; neighbor_side <= Right; neighbor_side++) {
+            bool exists = neighbor_side == Left ? has_left : has_right;
+            if (!exists) {
+                continue;
+            }
+
+            unsigned neighbor = neighbor_side == Left ? domain - 1 : domain + 1;
+            Side towards_us = neighbor_side == Left ? Right : Left;
+            OutboxHeader& outbox = exchange.outbox(neighbor, towards_us);
+            Particle* ghosts = exchange.ghosts(neighbor, towards_us);
+
+            particles.insert(particles.end(), ghosts, ghosts + outbox.ghost_count);
+            stats.ghosts_received += outbox.ghost_count;
+        }
+
+        // every outbox was read, they can be written again
+        exchange.wait();
+
+        collide(particles, own_count, strip, config.ghost_width, stats);
+        particles.resize(own_count);
+
+        for (Particle& particle : particles) {
+            resolve_bounds(particle, config.world);
+
+            //update physic values
+            particle.position += particle.velocity * config.delta_time;
+        }
+
+        // hand over the particles that left the strip
+        left.migrant_count = 0;
+        right.migrant_count = 0;
+
+        for (unsigned i = 0; i < particles.size();) {
+            Particle& particle = particles[i];
+            OutboxHeader* outbox = nullptr;
+            Side side = Left;
+
+            if (has_left && particle.position.x < strip.min.x) {
+                outbox = &left;
+                side = Left;
+            } else if (has_right && particle.position.x >= strip.max.x) {
+                outbox = &right;
+                side = Right;
+            }
+
+            if (!outbox) {
+                i++;
+                continue;
+            }
+
+            if (outbox->migrant_count >= capacity) {
+                // keep it one more step rather than losing it
+                stats.overflows++;
+                i++;
+                continue;
+            }
+
+            exchange.migrants(domain, side)[outbox->migrant_count++] = particle;
+            stats.migrants_sent++;
+
+            particle = particles.back();
+            particles.pop_back();
+        }
+    }
+
+    stats.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    // migrants of the last step are counted by the neighbor that never received them
+    stats.particles = (unsigned) particles.size() + exchange.outbox(domain, Left).migrant_count + exchange.outbox(domain, Right).migrant_count;
+    exchange.stats(domain) = stats;
+}
+
+std::vector<DomainStats> run_domains(const DomainConfig& config, const std::vector<Particle>& particles) {
+    DomainExchange exchange(config.domains, config.capacity);
+    if (!exchange.is_valid()) {
+        return {};
+    }
+
+    std::vector<pid_t> children;
+    for (unsigned domain = 0; domain < config.domains; domain++) {
+        AABB strip = domain_strip(config, domain);
+        bool first = domain == 0;
+        bool last = domain + 1 == config.domains;
+
+        std::vector<Particle> own;
+        for (const Particle& particle : particles) {
+            float x = particle.position.x;
+            if ((first || x >= strip.min.x) && (last || x < strip.max.x)) {
+                own.push_back(particle);
+            }
+        }
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            run_domain(exchange, config, domain, std::move(own));
+            _exit(0);
+        }
+
+        if (pid < 0) {
+            // the started domains would wait forever at the barrier
+            std::cout << "ERROR::DOMAIN::FORK_FAILED" << std::endl;
+            for (pid_t child : children) {
+                kill(child, SIGKILL);
+                waitpid(child, nullptr, 0);
+            }
+            return {};
+        }
+
+        children.push_back(pid);
+    }
+
+    bool failed = false;
+    for (pid_t child : children) {
+        int status = 0;
+        waitpid(child, &status, 0);
+        failed |= !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    }
+
+    if (failed) {
+        std::cout << "ERROR::DOMAIN::PROCESS_FAILED" << std::endl;
+        return {};
+    }
+
+    std::vector<DomainStats> stats(config.domains);
+    for (unsigned domain = 0; domain < config.domains; domain++) {
+        stats[domain] = exchange.stats(domain);
+    }
+
+    return stats;
+}
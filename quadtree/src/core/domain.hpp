@@ -0,0 +1,44 @@
+#ifndef SPATIAL_DATA_PARTITIONING_DOMAIN_HPP
+#define SPATIAL_DATA_PARTITIONING_DOMAIN_HPP
+
+#include <vector>
+
+#include "aabb.hpp"
+#include "particle.hpp"
+
+// Domain decomposition across processes. The world is split into vertical strips, one process per
+// strip. Every step each process receives the particles that crossed a border into its strip on the
+// previous step (migrants), publishes the particles close to its borders (ghosts) to its neighbors,
+// collides its own particles against its own and the neighbors ghosts, and hands the particles that
+// left its strip to the neighbor now owning them. Processes exchange them through a shared memory
+// mapping and synchronize with a process-shared barrier.
+
+struct DomainConfig {
+    AABB world;
+    unsigned domains = 1;
+    unsigned steps = 100;
+    float delta_time = 1.f / 60.f;
+    // particles closer than this to a border are sent to the neighbor as ghosts
+    float ghost_width = 6.f;
+    // ghosts, and migrants, a domain can send to each neighbor in one step
+    unsigned capacity = 4096;
+};
+
+struct DomainStats {
+    double elapsed_ms;
+    unsigned particles;
+    unsigned ghosts_received;
+    unsigned migrants_sent;
+    unsigned overflows;
+    // contacts resolved between own particles, and between an own particle and a ghost of the left
+    // or right neighbor. A contact across a border is resolved, and counted, by both domains.
+    unsigned long long contacts;
+    unsigned long long left_contacts;
+    unsigned long long right_contacts;
+};
+
+// Runs the simulation on config.domains processes and returns the stats of every domain,
+// an empty vector if the processes couldn't be started
+std::vector<DomainStats> run_domains(const DomainConfig& config, const std::vector<Particle>& particles);
+
+#endif //SPATIAL_DATA_PARTITIONING_DOMAIN_HPP
@@ -0,0 +1,64 @@
+#include "islands.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <numeric>
+
+unsigned ContactIslands::find(unsigned i) {
+    while (m_parent[i] != i) {
+        // path halving
+        m_parent[i] = m_parent[m_parent[i]];
+        i = m_parent[i];
+    }
+
+    return i;
+}
+
+void ContactIslands::build(const std::vector<Contact>& contacts, unsigned particles_count) {
+    m_parent.resize(particles_count);
+    std::iota(m_parent.begin(), m_parent.end(), 0);
+
+    for (const Contact& contact : contacts) {
+        unsigned a = find(contact.a);
+        unsigned b = find(contact.b);
+
+        if (a != b) {
+            m_parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    // number the islands and count their contacts
+    m_island_of.assign(particles_count, UINT_MAX);
+    std::vector<unsigned> sizes;
+
+    for (const Contact& contact : contacts) {
+        unsigned root = find(contact.a);
+
+        if (m_island_of[root] == UINT_MAX) {
+            m_island_of[root] = (unsigned) sizes.size();
+            sizes.push_back(0);
+        }
+        sizes[m_island_of[root]]++;
+    }
+
+    // largest islands first, so threads taking islands in order finish at about the same time
+    std::vector<unsigned> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&sizes](unsigned a, unsigned b) { return sizes[a] > sizes[b]; });
+
+    std::vector<unsigned> rank(sizes.size());
+    m_offsets.assign(sizes.size() + 1, 0);
+    for (unsigned i = 0; i < order.size(); i++) {
+        rank[order[i]] = i;
+        m_offsets[i + 1] = m_offsets[i] + sizes[order[i]];
+    }
+
+    // scatter the contacts into their island ranges
+    std::vector<unsigned> cursor(m_offsets.begin(), m_offsets.end() - 1);
+    m_contacts.resize(contacts.size());
+
+    for (const Contact& contact : contacts) {
+        unsigned island = rank[m_island_of[find(contact.a)]];
+        m_contacts[cursor[island]++] = contact;
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef SPATIAL_DATA_PARTITIONING_ISLANDS_HPP
+#define SPATIAL_DATA_PARTITIONING_ISLANDS_HPP
+
+#include <vector>
+
+struct Contact {
+    unsigned a;
+    unsigned b;
+};
+
+// Groups contacts into islands, the connected components of the contact graph. Islands share no
+// particle, so each one can be solved by a different thread without synchronization.
+class ContactIslands {
+public:
+    void build(const std::vector<Contact>& contacts, unsigned particles_count);
+
+    unsigned get_island_count() const { return m_offsets.empty() ? 0 : (unsigned) m_offsets.size() - 1; }
+
+    // contacts of an island, islands are sorted from the largest to the smallest
+    const Contact* begin(unsigned island) const { return m_contacts.data() + m_offsets[island]; }
+    const Contact* end(unsigned island) const { return m_contacts.data() + m_offsets[island + 1]; }
+
+private:
+    unsigned find(unsigned i);
+
+    std::vector<unsigned> m_parent;
+    std::vector<unsigned> m_island_of;
+    std::vector<unsigned> m_offsets;
+    std::vector<Contact> m_contacts;
+};
+
+#endif //SPATIAL_DATA_PARTITIONING_ISLANDS_HPP
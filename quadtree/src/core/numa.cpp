@@ -0,0 +1,398 @@
+#include "numa.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// parses a sysfs list such as "0-3,8-11"
+static std::vector<unsigned> parse_list(const std::string& list)
+{
+    std::vector<unsigned> values;
+    std::stringstream stream(list);
+    std::string range;
+
+    while (std::getline(stream, range, ','))
+    {
+        if (range.empty() || range[0] < '0' || range[0] > '9')
+        {
+            continue;
+        }
+
+        size_t dash = range.find('-');
+        unsigned first = (unsigned) std::stoul(range.substr(0, dash));
+        unsigned last = dash == std::string::npos ? first : (unsigned) std::stoul(range.substr(dash + 1));
+
+        for (unsigned value = first; value <= last; value++)
+        {
+            values.push_back(value);
+        }
+    }
+
+    return values;
+}
+
+static std::string read_line(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+
+    return line;
+}
+
+// CPUs the process may run on
+static std::vector<unsigned> allowed_cpus()
+{
+    std::vector<unsigned> cpus;
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET(cpu, &set))
+            {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+
+    if (cpus.empty())
+    {
+        for (unsigned cpu = 0; cpu < glm::max(1u, std::thread::hardware_concurrency()); cpu++)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+NumaTopology NumaTopology::detect()
+{
+    NumaTopology topology;
+    std::vector<unsigned> allowed = allowed_cpus();
+
+    for (unsigned node : parse_list(read_line("/sys/devices/system/node/online")))
+    {
+        std::string cpulist = read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+
+        NumaNode numa_node = {(int) node, {}};
+        for (unsigned cpu : parse_list(cpulist))
+        {
+            if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end())
+            {
+                numa_node.cpus.push_back(cpu);
+            }
+        }
+
+        // memory only nodes or nodes the process can't run on get no thread
+        if (!numa_node.cpus.empty())
+        {
+            topology.m_nodes.push_back(numa_node);
+        }
+    }
+
+    if (topology.m_nodes.empty())
+    {
+        topology.m_nodes.push_back({-1, allowed});
+    }
+
+    return topology;
+}
+
+NumaTopology NumaTopology::fake(unsigned node_count)
+{
+    NumaTopology topology;
+    std::vector<unsigned> allowed = allowed_cpus();
+    node_count = glm::clamp(node_count, 1u, (unsigned) allowed.size());
+
+    for (unsigned node = 0; node < node_count; node++)
+    {
+        size_t first = allowed.size() * node / node_count;
+        size_t last = allowed.size() * (node + 1) / node_count;
+
+        topology.m_nodes.push_back({0, std::vector<unsigned>(allowed.begin() + first, allowed.begin() + last)});
+    }
+
+    return topology;
+}
+
+unsigned NumaTopology::get_cpu_count() const
+{
+    unsigned count = 0;
+    for (const NumaNode& node : m_nodes)
+    {
+        count += (unsigned) node.cpus.size();
+    }
+
+    return count;
+}
+
+unsigned NumaTopology::node_of_thread(unsigned thread, unsigned thread_count) const
+{
+    return (unsigned) ((size_t) thread * m_nodes.size() / thread_count);
+}
+
+unsigned NumaTopology::cpu_of_thread(unsigned thread, unsigned thread_count) const
+{
+    unsigned node = node_of_thread(thread, thread_count);
+    // first thread whose node is node
+    unsigned first = (unsigned) (((size_t) node * thread_count + m_nodes.size() - 1) / m_nodes.size());
+    const std::vector<unsigned>& cpus = m_nodes[node].cpus;
+
+    return cpus[(thread - first) % cpus.size()];
+}
+
+std::string NumaTopology::describe() const
+{
+    std::stringstream description;
+
+    for (unsigned node = 0; node < m_nodes.size(); node++)
+    {
+        description << (node ? ", " : "") << "node " << node << ": " << m_nodes[node].cpus.size() << " cpus";
+        if (m_nodes[node].memory_node >= 0)
+        {
+            description << " memory " << m_nodes[node].memory_node;
+        }
+    }
+
+    return description.str();
+}
+
+bool pin_current_thread(unsigned cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+bool bind_memory(void* address, size_t size, int memory_node)
+{
+#ifdef __linux__
+    if (memory_node < 0 || memory_node >= (int) (8 * sizeof(unsigned long)))
+    {
+        return false;
+    }
+
+    // preferred rather than bound, a full node spills over instead of failing the allocation
+    unsigned long mask = 1ul << memory_node;
+    return syscall(SYS_mbind, address, size, MPOL_PREFERRED, &mask, 8 * sizeof(mask), 0) == 0;
+#else
+    return false;
+#endif
+}
+
+NumaParticles::NumaParticles(const NumaTopology& topology, unsigned count, unsigned thread_count)
+    : m_topology(topology), m_particles(nullptr), m_count(count), m_thread_count(glm::max(1u, thread_count))
+{
+    m_size = sizeof(Particle) * count;
+
+#ifdef __linux__
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    m_size = (m_size + page - 1) / page * page;
+
+    void* memory = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        std::cout << "ERROR::NUMA::MMAP_FAILED" << std::endl;
+        memory = nullptr;
+        m_size = 0;
+    }
+    m_particles = (Particle*) memory;
+
+    bool bound = m_particles != nullptr;
+    for (unsigned thread = 0; m_particles && thread < m_thread_count; thread++)
+    {
+        // a page belongs to the slice holding its first byte
+        size_t first = (sizeof(Particle) * begin(thread) + page - 1) / page * page;
+        size_t last = (sizeof(Particle) * end(thread) + page - 1) / page * page;
+        int memory_node = m_topology.get_node(m_topology.node_of_thread(thread, m_thread_count)).memory_node;
+
+        if (last > first && memory_node >= 0)
+        {
+            bound &= bind_memory((char*) m_particles + first, last - first, memory_node);
+        }
+    }
+
+    if (!bound)
+    {
+        std::cout << "WARNING::NUMA::MBIND_FAILED relying on first touch" << std::endl;
+    }
+#endif
+
+    if (!m_particles)
+    {
+        m_particles = new Particle[count];
+        m_size = 0;
+    }
+
+    // each slice is first written by a thread of its node, so its pages are allocated there.
+    // The calling thread isn't used, it must not stay pinned.
+    std::vector<std::thread> threads;
+    for (unsigned thread = 0; thread < m_thread_count; thread++)
+    {
+        threads.emplace_back([this, thread]() {
+            pin_current_thread(m_topology.cpu_of_thread(thread, m_thread_count));
+            std::memset((void*) (m_particles + begin(thread)), 0, sizeof(Particle) * (end(thread) - begin(thread)));
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+NumaParticles::~NumaParticles()
+{
+#ifdef __linux__
+    if (m_size)
+    {
+        munmap(m_particles, m_size);
+        return;
+    }
+#endif
+
+    delete[] m_particles;
+}
+
+float NumaParticles::remote_page_ratio() const
+{
+#ifdef __linux__
+    if (!m_size)
+    {
+        return -1.f;
+    }
+
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t page_count = m_size / page;
+    std::vector<void*> pages(page_count);
+    std::vector<int> status(page_count, -1);
+
+    for (size_t i = 0; i < page_count; i++)
+    {
+        pages[i] = (char*) m_particles + i * page;
+    }
+
+    // without target nodes move_pages only reports the node of every page
+    if (syscall(SYS_move_pages, 0, page_count, pages.data(), nullptr, status.data(), 0) != 0)
+    {
+        return -1.f;
+    }
+
+    size_t resident = 0, remote = 0;
+    for (size_t i = 0; i < page_count; i++)
+    {
+        if (status[i] < 0)
+        {
+            continue;
+        }
+
+        // owner of the page's first byte, as when binding
+        unsigned particle = (unsigned) glm::min(i * page / sizeof(Particle), (size_t) m_count - 1);
+        unsigned thread = glm::min(particle / glm::max(1u, m_count / m_thread_count), m_thread_count - 1);
+        int memory_node = m_topology.get_node(m_topology.node_of_thread(thread, m_thread_count)).memory_node;
+
+        resident++;
+        remote += memory_node >= 0 && status[i] != memory_node;
+    }
+
+    return resident ? (float) remote / (float) resident : -1.f;
+#else
+    return -1.f;
+#endif
+}
+
+PinnedWorkers::PinnedWorkers(const NumaTopology& topology, unsigned thread_count)
+{
+    thread_count = glm::max(1u, thread_count);
+
+    for (unsigned thread = 0; thread < thread_count; thread++)
+    {
+        unsigned cpu = topology.cpu_of_thread(thread, thread_count);
+        m_threads.emplace_back([this, thread, cpu]() {
+            if (!pin_current_thread(cpu))
+            {
+                std::cout << "WARNING::NUMA::PIN_FAILED thread " << thread << " cpu " << cpu << std::endl;
+            }
+            work(thread);
+        });
+    }
+}
+
+PinnedWorkers::~PinnedWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_start.notify_all();
+
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void PinnedWorkers::run(const std::function<void(unsigned)>& job)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_job = &job;
+    m_pending = (unsigned) m_threads.size();
+    m_generation++;
+    m_start.notify_all();
+
+    m_done.wait(lock, [this]() { return m_pending == 0; });
+    m_job = nullptr;
+}
+
+void PinnedWorkers::work(unsigned thread)
+{
+    unsigned generation = 0;
+
+    while (true)
+    {
+        const std::function<void(unsigned)>* job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start.wait(lock, [this, generation]() { return m_stop || m_generation != generation; });
+            if (m_stop)
+            {
+                return;
+            }
+
+            generation = m_generation;
+            job = m_job;
+        }
+
+        (*job)(thread);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pending == 0)
+        {
+            m_done.notify_one();
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef SPATIAL_DATA_PARTITIONING_NUMA_HPP
+#define SPATIAL_DATA_PARTITIONING_NUMA_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "particle.hpp"
+
+struct NumaNode {
+    // memory node pages of this node are bound to, -1 to leave placement to the kernel
+    int memory_node;
+    std::vector<unsigned> cpus;
+};
+
+// CPUs and memory nodes of the machine, restricted to the CPUs the process may run on.
+// Threads are spread evenly over the nodes, consecutive threads sharing a node, so thread i of n
+// owns the i-th slice of the particles and that slice lives on the thread's node.
+class NumaTopology {
+public:
+    // reads /sys/devices/system/node, a single node holding every CPU when it's unavailable
+    static NumaTopology detect();
+    // splits the CPUs in node_count nodes whose memory all lives on node 0, to test on any machine
+    static NumaTopology fake(unsigned node_count);
+
+    unsigned get_node_count() const { return (unsigned) m_nodes.size(); }
+    const NumaNode& get_node(unsigned node) const { return m_nodes[node]; }
+    unsigned get_cpu_count() const;
+
+    unsigned node_of_thread(unsigned thread, unsigned thread_count) const;
+    unsigned cpu_of_thread(unsigned thread, unsigned thread_count) const;
+
+    std::string describe() const;
+
+private:
+    std::vector<NumaNode> m_nodes;
+};
+
+// pins the calling thread to cpu, false when it isn't supported or allowed
+bool pin_current_thread(unsigned cpu);
+// prefers memory_node for the pages of [address, address + size) touched from now on
+bool bind_memory(void* address, size_t size, int memory_node);
+
+// Particle array whose slices are placed on the nodes of the threads that own them: each slice is bound
+// to its node, then first touched by a thread pinned to that node.
+class NumaParticles {
+public:
+    NumaParticles(const NumaTopology& topology, unsigned count, unsigned thread_count);
+    ~NumaParticles();
+
+    NumaParticles(const NumaParticles&) = delete;
+    NumaParticles& operator=(const NumaParticles&) = delete;
+
+    Particle* data() { return m_particles; }
+
+    // slice of a thread, the last one takes the remainder
+    unsigned begin(unsigned thread) const { return m_count / m_thread_count * thread; }
+    unsigned end(unsigned thread) const { return thread + 1 == m_thread_count ? m_count : begin(thread + 1); }
+
+    // fraction of the resident pages lying on another node than their slice's, as reported by
+    // move_pages, negative when unknown. It tells where the pages are, not how often they're accessed.
+    float remote_page_ratio() const;
+
+private:
+    NumaTopology m_topology;
+    Particle* m_particles;
+    size_t m_size;
+    unsigned m_count;
+    unsigned m_thread_count;
+};
+
+// One worker per thread slot, pinned to the core cpu_of_thread gives it once when it starts and kept
+// for the whole run, so the affinity isn't set again every frame.
+class PinnedWorkers {
+public:
+    PinnedWorkers(const NumaTopology& topology, unsigned thread_count);
+    ~PinnedWorkers();
+
+    PinnedWorkers(const PinnedWorkers&) = delete;
+    PinnedWorkers& operator=(const PinnedWorkers&) = delete;
+
+    // runs job(thread) on every worker and waits until all of them are done
+    void run(const std::function<void(unsigned)>& job);
+
+    unsigned get_thread_count() const { return (unsigned) m_threads.size(); }
+
+private:
+    void work(unsigned thread);
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    const std::function<void(unsigned)>* m_job = nullptr;
+    // bumped by every run, a worker waits for the next one
+    unsigned m_generation = 0;
+    unsigned m_pending = 0;
+    bool m_stop = false;
+};
+
+#endif //SPATIAL_DATA_PARTITIONING_NUMA_HPP
@@ -0,0 +1,58 @@
+#include "options.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+Options parse_options(int argc, char const *argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(arg, "--snapshot") == 0 && value) {
+            options.snapshot_path = value;
+            i++;
+        } else if (std::strcmp(arg, "--save-snapshot") == 0 && value) {
+            options.save_snapshot_path = value;
+            i++;
+        } else if (std::strcmp(arg, "--snapshot-interval") == 0 && value) {
+            options.snapshot_interval = std::strtof(value, nullptr);
+            i++;
+        } else if (std::strcmp(arg, "--record") == 0 && value) {
+            options.record_path = value;
+            i++;
+        } else if (std::strcmp(arg, "--scenario") == 0 && value) {
+            options.scenario = value;
+            i++;
+        } else if (std::strcmp(arg, "--seed") == 0 && value) {
+            options.seed = (unsigned) std::strtoul(value, nullptr, 10);
+            i++;
+        } else if (std::strcmp(arg, "--numa") == 0) {
+            options.numa = true;
+        } else if (std::strcmp(arg, "--numa-fake") == 0 && value) {
+            options.numa = true;
+            options.numa_fake_nodes = (unsigned) std::strtoul(value, nullptr, 10);
+            i++;
+        } else if (std::strcmp(arg, "--replay") == 0 && value) {
+            options.replay_path = value;
+            i++;
+        } else if (std::strcmp(arg, "--islands") == 0) {
+            options.islands = true;
+        } else if (std::strcmp(arg, "--sleep-velocity") == 0 && value) {
+            options.sleep.velocity = std::strtof(value, nullptr);
+            i++;
+        } else if (std::strcmp(arg, "--sleep-impulse") == 0 && value) {
+            options.sleep.impulse = std::strtof(value, nullptr);
+            i++;
+        } else if (std::strcmp(arg, "--sleep-steps") == 0 && value) {
+            options.sleep.steps = (unsigned) std::strtoul(value, nullptr, 10);
+            i++;
+        } else {
+            std::cout << "WARNING::OPTIONS::UNKNOWN_ARGUMENT " << arg << std::endl;
+        }
+    }
+
+    return options;
+}
@@ -0,0 +1,36 @@
+#ifndef SPATIAL_DATA_PARTITIONING_OPTIONS_HPP
+#define SPATIAL_DATA_PARTITIONING_OPTIONS_HPP
+
+#include <string>
+
+#include "activity.hpp"
+
+struct Options {
+    // --snapshot <file>: start from a recorded snapshot instead of init_particles
+    std::string snapshot_path;
+    // --save-snapshot <file>: periodically write the particle state to <file>
+    std::string save_snapshot_path;
+    // --snapshot-interval <seconds>
+    float snapshot_interval = 10.f;
+    // --record <file>: stream every frame positions and velocities to <file>
+    std::string record_path;
+    // --replay <file>: collisions_replay plays back a recorded trajectory
+    std::string replay_path;
+    // --islands: let settled particles sleep and solve the contact islands in parallel
+    bool islands = false;
+    // --sleep-velocity <px/s>, --sleep-impulse <px/s>, --sleep-steps <n>: when particles fall asleep with --islands
+    SleepThresholds sleep;
+    // --scenario <name>: initial distribution, see scenarios.hpp
+    std::string scenario = "uniform";
+    // --seed <n>: the same seed gives the same initial particles
+    unsigned seed = 42;
+    // --numa: pin the worker threads and place their particles and trees on their NUMA node
+    // (collisions_quadtree_threads)
+    bool numa = false;
+    // --numa-fake <nodes>: same with a made up topology of <nodes> nodes, 0 to detect the real one
+    unsigned numa_fake_nodes = 0;
+};
+
+Options parse_options(int argc, char const *argv[]);
+
+#endif //SPATIAL_DATA_PARTITIONING_OPTIONS_HPP
@@ -13,4 +13,20 @@ struct Particle {
     bool intersect(Particle& other) {
         return glm::distance(position, other.position) <= radius + other.radius;
     }
-};
\ No newline at end of file
+};
+
+struct Particle3D {
+    glm::vec3 position;
+    glm::vec3 velocity;
+    float radius;
+    glm::vec3 color;
+
+    bool intersect(Particle3D& other) {
+        return glm::distance(position, other.position) <= radius + other.radius;
+    }
+};
+
+// particle type stored by the spatial trees of each dimension
+template<int Dim> struct ParticleOf;
+template<> struct ParticleOf<2> { using type = Particle; };
+template<> struct ParticleOf<3> { using type = Particle3D; };
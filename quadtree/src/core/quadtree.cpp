@@ -1,11 +1,16 @@
 #include "quadtree.h"
 
 #include <iostream>
+#include <queue>
 
-QuadTree::QuadTree(glm::vec2 position, float half_range, unsigned capacity)
+// nodes smaller than this keep every particle instead of subdividing, so particles piled on the
+// same point can't recurse forever
+const float min_half_size = 1e-3f;
+
+QuadTree::QuadTree(glm::vec2 position, glm::vec2 half_size, unsigned capacity)
 {
     m_position = position;
-    m_half_range = half_range;
+    m_half_size = half_size;
     m_elements = std::vector<Particle*>(capacity);
     m_capacity = capacity;
 
@@ -22,10 +27,16 @@ bool QuadTree::insert(Particle* element)
         return false;
     }
 
+    m_max_radius = glm::max(m_max_radius, element->radius);
+
     if (m_count < m_capacity)
     {
         m_elements[m_count++] = element;
         return true;
+    } else if (m_top_left == nullptr && glm::max(m_half_size.x, m_half_size.y) < min_half_size) {
+        m_elements.push_back(element);
+        m_count++;
+        return true;
     } else if (m_top_left == nullptr) {
         subdivide();
     }
@@ -40,17 +51,17 @@ bool QuadTree::insert(Particle* element)
 
 void QuadTree::subdivide()
 {
-    float half_range = m_half_range / 2;
+    glm::vec2 half_size = m_half_size / 2.f;
 
-    glm::vec2 top_left_pos = m_position-half_range; 
-    glm::vec2 top_right_pos = {m_position.x+half_range, m_position.y-half_range}; 
-    glm::vec2 bot_left_pos = {m_position.x-half_range, m_position.y+half_range}; 
-    glm::vec2 bot_right_pos = m_position+half_range; 
+    glm::vec2 top_left_pos = m_position-half_size;
+    glm::vec2 top_right_pos = {m_position.x+half_size.x, m_position.y-half_size.y};
+    glm::vec2 bot_left_pos = {m_position.x-half_size.x, m_position.y+half_size.y};
+    glm::vec2 bot_right_pos = m_position+half_size;
 
-    m_top_left = std::make_unique<QuadTree>(top_left_pos, half_range, m_capacity);
-    m_top_right = std::make_unique<QuadTree>(top_right_pos, half_range, m_capacity);
-    m_bot_left = std::make_unique<QuadTree>(bot_left_pos, half_range, m_capacity);
-    m_bot_right = std::make_unique<QuadTree>(bot_right_pos, half_range, m_capacity);
+    m_top_left = std::make_unique<QuadTree>(top_left_pos, half_size, m_capacity);
+    m_top_right = std::make_unique<QuadTree>(top_right_pos, half_size, m_capacity);
+    m_bot_left = std::make_unique<QuadTree>(bot_left_pos, half_size, m_capacity);
+    m_bot_right = std::make_unique<QuadTree>(bot_right_pos, half_size, m_capacity);
 }
 
 void QuadTree::query(Particle* particle, std::vector<Particle*>* found)
@@ -80,32 +91,153 @@ void QuadTree::query(Particle* particle, std::vector<Particle*>* found)
     }
 }
 
+void QuadTree::query_range(const AABB& range, std::vector<Particle*>* found)
+{
+    if (!bounds().intersects(range))
+    {
+        return;
+    }
+
+    for (unsigned i = 0; i < m_count; i++)
+    {
+        if (range.contains(m_elements[i]->position))
+        {
+            found->push_back(m_elements[i]);
+        }
+    }
+
+    if (m_top_left)
+    {
+        m_top_left->query_range(range, found);
+        m_top_right->query_range(range, found);
+        m_bot_left->query_range(range, found);
+        m_bot_right->query_range(range, found);
+    }
+}
+
+void QuadTree::query_radius(glm::vec2 center, float radius, std::vector<Particle*>* found)
+{
+    float radius2 = radius * radius;
+
+    if (bounds().distance2(center) > radius2)
+    {
+        return;
+    }
+
+    for (unsigned i = 0; i < m_count; i++)
+    {
+        glm::vec2 delta = m_elements[i]->position - center;
+        if (glm::dot(delta, delta) <= radius2)
+        {
+            found->push_back(m_elements[i]);
+        }
+    }
+
+    if (m_top_left)
+    {
+        m_top_left->query_radius(center, radius, found);
+        m_top_right->query_radius(center, radius, found);
+        m_bot_left->query_radius(center, radius, found);
+        m_bot_right->query_radius(center, radius, found);
+    }
+}
+
+void QuadTree::nearest(glm::vec2 point, unsigned k, std::vector<Particle*>* found)
+{
+    // best-first search: nodes are keyed by the distance to their bounds and particles by their own
+    // distance, so a particle reaching the top of the queue is closer than anything left in the tree
+    struct Entry {
+        float distance2;
+        QuadTree* node;
+        Particle* particle;
+
+        bool operator>(const Entry& other) const { return distance2 > other.distance2; }
+    };
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    queue.push({bounds().distance2(point), this, nullptr});
+
+    unsigned remaining = k;
+    while (remaining > 0 && !queue.empty())
+    {
+        Entry entry = queue.top();
+        queue.pop();
+
+        if (entry.particle)
+        {
+            found->push_back(entry.particle);
+            remaining--;
+            continue;
+        }
+
+        QuadTree* node = entry.node;
+        for (unsigned i = 0; i < node->m_count; i++)
+        {
+            glm::vec2 delta = node->m_elements[i]->position - point;
+            queue.push({glm::dot(delta, delta), nullptr, node->m_elements[i]});
+        }
+
+        if (node->m_top_left)
+        {
+            for (QuadTree* child : {node->m_top_left.get(), node->m_top_right.get(), node->m_bot_left.get(), node->m_bot_right.get()})
+            {
+                queue.push({child->bounds().distance2(point), child, nullptr});
+            }
+        }
+    }
+}
+
 bool QuadTree::contains(Particle* particle)
 {
     return (
-        particle->position.x >= m_position.x - m_half_range &&
-        particle->position.x <= m_position.x + m_half_range &&
-        particle->position.y >= m_position.y - m_half_range &&
-        particle->position.y <= m_position.y + m_half_range
+        particle->position.x >= m_position.x - m_half_size.x &&
+        particle->position.x <= m_position.x + m_half_size.x &&
+        particle->position.y >= m_position.y - m_half_size.y &&
+        particle->position.y <= m_position.y + m_half_size.y
     );
 }
 
 bool QuadTree::intersect(Particle* particle)
 {
+    // elements are stored by their center, one can touch the particle from up to its radius outside the node
+    float reach = particle->radius + m_max_radius;
+
     return (
-        particle->position.x >= m_position.x - (m_half_range + particle->radius) &&
-        particle->position.x <= m_position.x + (m_half_range + particle->radius) &&
-        particle->position.y >= m_position.y - (m_half_range + particle->radius) &&
-        particle->position.y <= m_position.y + (m_half_range + particle->radius)
+        particle->position.x >= m_position.x - (m_half_size.x + reach) &&
+        particle->position.x <= m_position.x + (m_half_size.x + reach) &&
+        particle->position.y >= m_position.y - (m_half_size.y + reach) &&
+        particle->position.y <= m_position.y + (m_half_size.y + reach)
     );
 }
 
+unsigned QuadTree::depth() const
+{
+    if (!m_top_left)
+    {
+        return 1;
+    }
+
+    return 1 + glm::max(glm::max(m_top_left->depth(), m_top_right->depth()), glm::max(m_bot_left->depth(), m_bot_right->depth()));
+}
+
+size_t QuadTree::memory() const
+{
+    size_t bytes = sizeof(QuadTree) + m_elements.capacity() * sizeof(Particle*);
+
+    if (m_top_left)
+    {
+        bytes += m_top_left->memory() + m_top_right->memory() + m_bot_left->memory() + m_bot_right->memory();
+    }
+
+    return bytes;
+}
+
 void QuadTree::draw(unsigned vao, unsigned shaderProgram)
 {
     static float color[3] = {1.f,1.f,1.f};
     glm::mat4 model          = glm::mat4(1.0f);
     model       = glm::translate(model, glm::vec3(m_position, 0.0f));
-    model       = glm::scale(model, glm::vec3(m_half_range, m_half_range, 0.0f));
+    model       = glm::scale(model, glm::vec3(m_half_size, 0.0f));
 
     glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, &model[0][0]);
     glUniform3fv(glGetUniformLocation(shaderProgram, "color"), 1, &color[0]);
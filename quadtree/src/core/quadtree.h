@@ -9,25 +9,41 @@
 #include "glm/gtc/matrix_transform.hpp"
 
 #include "particle.hpp"
+#include "aabb.hpp"
 
 class QuadTree {
 public:
-    QuadTree(glm::vec2 position, float half_range, unsigned capacity);
+    QuadTree(glm::vec2 position, glm::vec2 half_size, unsigned capacity);
+    QuadTree(const AABB& bounds, unsigned capacity) : QuadTree((bounds.min + bounds.max) / 2.f, (bounds.max - bounds.min) / 2.f, capacity) {}
     ~QuadTree() = default;
 
     bool insert(Particle* particle);
     void subdivide();
     void query(Particle* particle, std::vector<Particle*>* found);
+    // particles whose position lies inside range
+    void query_range(const AABB& range, std::vector<Particle*>* found);
+    // particles whose position lies within radius of center
+    void query_radius(glm::vec2 center, float radius, std::vector<Particle*>* found);
+    // k particles closest to point, ordered by distance
+    void nearest(glm::vec2 point, unsigned k, std::vector<Particle*>* found);
     bool contains(Particle* particle);
     bool intersect(Particle* particle);
     void draw(unsigned vao, unsigned shaderProgram);
 
+    AABB bounds() const { return AABB::from_center(m_position, m_half_size); }
+    // depth of the deepest node, the root being 1
+    unsigned depth() const;
+    // bytes used by this node and its children
+    size_t memory() const;
+
 private:
     glm::vec2 m_position;
-    float m_half_range;
+    glm::vec2 m_half_size;
     std::vector<Particle*> m_elements;
     unsigned m_capacity;
     unsigned m_count = 0;
+    // largest radius of the elements of this node and its children
+    float m_max_radius = 0.f;
 
     std::unique_ptr<QuadTree> m_top_left;
     std::unique_ptr<QuadTree> m_top_right;
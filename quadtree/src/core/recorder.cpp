@@ -0,0 +1,235 @@
+#include "recorder.hpp"
+#include "application.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+static inline int32_t quantize(float value, float step) {
+    return (int32_t) std::lround(value / step);
+}
+
+static inline void write_varint(std::vector<uint8_t>& buffer, int32_t value) {
+    // zigzag, so small negative deltas stay small
+    uint32_t encoded = ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+
+    while (encoded >= 0x80) {
+        buffer.push_back((uint8_t) (encoded | 0x80));
+        encoded >>= 7;
+    }
+    buffer.push_back((uint8_t) encoded);
+}
+
+static inline bool read_varint(const uint8_t*& cursor, const uint8_t* end, int32_t& value) {
+    uint32_t encoded = 0;
+
+    for (unsigned shift = 0; shift < 7 * max_varint_size && cursor < end; shift += 7) {
+        uint8_t byte = *cursor++;
+        encoded |= (uint32_t) (byte & 0x7f) << shift;
+
+        if (!(byte & 0x80)) {
+            value = (int32_t) (encoded >> 1) ^ -(int32_t) (encoded & 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+TrajectoryRecorder::TrajectoryRecorder(const std::string& path, unsigned count, float position_step,
+                                       float velocity_step, unsigned keyframe_interval)
+    : m_file(path, std::ios::binary | std::ios::trunc),
+      m_count(count),
+      m_position_step(position_step),
+      m_velocity_step(velocity_step),
+      m_keyframe_interval(keyframe_interval),
+      m_previous(count * 4, 0)
+{
+    if (!m_file) {
+        std::cout << "ERROR::RECORDER::OPEN_FAILED " << path << std::endl;
+        return;
+    }
+
+    TrajectoryHeader header = {};
+    std::memcpy(header.magic, trajectory_magic, sizeof(header.magic));
+    header.version = trajectory_version;
+    header.particles_count = count;
+    header.keyframe_interval = keyframe_interval;
+    header.position_step = position_step;
+    header.velocity_step = velocity_step;
+    m_file.write((const char*) &header, sizeof(header));
+
+    m_back.reserve(sizeof(TrajectoryFrameHeader) + count * 4 * max_varint_size);
+    m_front.reserve(m_back.capacity());
+
+    m_writer = std::thread(&TrajectoryRecorder::write_loop, this);
+}
+
+TrajectoryRecorder::~TrajectoryRecorder() {
+    if (m_writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_one();
+        m_writer.join();
+    }
+
+    if (m_dropped_frames) {
+        std::cout << "WARNING::RECORDER::DROPPED_FRAMES " << m_dropped_frames << " of "
+                  << m_recorded_frames + m_dropped_frames << " frames, the disk couldn't keep up" << std::endl;
+    }
+}
+
+void TrajectoryRecorder::capture(const Particle* particles, unsigned frame, float time) {
+    if (!m_file.is_open()) {
+        return;
+    }
+
+    if (m_front_busy.load(std::memory_order_acquire)) {
+        m_dropped_frames++;
+        return;
+    }
+
+    encode(particles, frame, time);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::swap(m_back, m_front);
+        m_front_busy.store(true, std::memory_order_release);
+    }
+    m_condition.notify_one();
+
+    m_recorded_frames++;
+}
+
+void TrajectoryRecorder::encode(const Particle* particles, unsigned index, float time) {
+    TrajectoryFrameHeader frame = {};
+    frame.index = index;
+    frame.keyframe = m_keyframe_interval == 0 || m_recorded_frames % m_keyframe_interval == 0;
+    frame.time = time;
+
+    if (frame.keyframe) {
+        std::fill(m_previous.begin(), m_previous.end(), 0);
+    }
+
+    m_back.resize(sizeof(TrajectoryFrameHeader));
+
+    int32_t* previous = m_previous.data();
+    for (unsigned i = 0; i < m_count; i++, previous += 4) {
+        const Particle& particle = particles[i];
+        int32_t values[4] = {
+            quantize(particle.position.x, m_position_step),
+            quantize(particle.position.y, m_position_step),
+            quantize(particle.velocity.x, m_velocity_step),
+            quantize(particle.velocity.y, m_velocity_step)
+        };
+
+        for (unsigned v = 0; v < 4; v++) {
+            write_varint(m_back, values[v] - previous[v]);
+            previous[v] = values[v];
+        }
+    }
+
+    frame.payload_size = (uint32_t) (m_back.size() - sizeof(TrajectoryFrameHeader));
+    std::memcpy(m_back.data(), &frame, sizeof(frame));
+}
+
+void TrajectoryRecorder::write_loop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true) {
+        m_condition.wait(lock, [this]() { return m_stop || m_front_busy.load(std::memory_order_acquire); });
+
+        if (m_front_busy.load(std::memory_order_acquire)) {
+            // the front buffer belongs to this thread until m_front_busy is cleared
+            lock.unlock();
+            m_file.write((const char*) m_front.data(), (std::streamsize) m_front.size());
+            lock.lock();
+            m_front_busy.store(false, std::memory_order_release);
+        } else if (m_stop) {
+            break;
+        }
+    }
+
+    m_file.flush();
+}
+
+TrajectoryReader::TrajectoryReader(const std::string& path) : m_file(path, std::ios::binary) {
+    if (!m_file.read((char*) &m_header, sizeof(m_header)) ||
+        std::memcmp(m_header.magic, trajectory_magic, sizeof(m_header.magic)) != 0 ||
+        m_header.version != trajectory_version ||
+        m_header.particles_count > max_trajectory_particles ||
+        !(m_header.position_step > 0.f) || !(m_header.velocity_step > 0.f)) {
+        std::cout << "ERROR::RECORDER::INVALID_FILE " << path << std::endl;
+        return;
+    }
+
+    m_previous = std::vector<int32_t>(m_header.particles_count * 4, 0);
+    m_valid = true;
+}
+
+bool TrajectoryReader::next_frame(Particle* particles, TrajectoryFrameHeader* frame) {
+    TrajectoryFrameHeader header = {};
+    if (!m_valid || !m_file.read((char*) &header, sizeof(header))) {
+        return false;
+    }
+
+    // sizes come from the file, every value takes between 1 and max_varint_size bytes
+    uint64_t values = (uint64_t) m_header.particles_count * 4;
+    if (header.payload_size < values || header.payload_size > values * max_varint_size) {
+        std::cout << "ERROR::RECORDER::INVALID_FRAME " << header.index << " payload of " << header.payload_size
+                  << " bytes for " << m_header.particles_count << " particles" << std::endl;
+        m_valid = false;
+        return false;
+    }
+
+    m_payload.resize(header.payload_size);
+    if (!m_file.read((char*) m_payload.data(), header.payload_size)) {
+        // truncated last frame, the recorder was interrupted mid write
+        return false;
+    }
+
+    if (header.keyframe) {
+        std::fill(m_previous.begin(), m_previous.end(), 0);
+    }
+
+    const uint8_t* cursor = m_payload.data();
+    const uint8_t* end = cursor + m_payload.size();
+    int32_t* previous = m_previous.data();
+
+    for (unsigned i = 0; i < m_header.particles_count; i++, previous += 4) {
+        for (unsigned v = 0; v < 4; v++) {
+            int32_t delta;
+            if (!read_varint(cursor, end, delta)) {
+                std::cout << "ERROR::RECORDER::INVALID_FRAME " << header.index << " payload ends early" << std::endl;
+                m_valid = false;
+                return false;
+            }
+            previous[v] += delta;
+        }
+
+        Particle& particle = particles[i];
+        particle.position = {(float) previous[0] * m_header.position_step, (float) previous[1] * m_header.position_step};
+        particle.velocity = {(float) previous[2] * m_header.velocity_step, (float) previous[3] * m_header.velocity_step};
+    }
+
+    if (cursor != end) {
+        std::cout << "ERROR::RECORDER::INVALID_FRAME " << header.index << " payload longer than its particles" << std::endl;
+        m_valid = false;
+        return false;
+    }
+
+    if (frame) {
+        *frame = header;
+    }
+
+    return true;
+}
+
+std::function<void()> recorder_system(TrajectoryRecorder* recorder, const Particle* particles) {
+    return [recorder, particles, frame = 0u, time = 0.f]() mutable {
+        time += Application::delta_time;
+        recorder->capture(particles, frame++, time);
+    };
+}
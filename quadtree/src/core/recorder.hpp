@@ -0,0 +1,111 @@
+#ifndef SPATIAL_DATA_PARTITIONING_RECORDER_HPP
+#define SPATIAL_DATA_PARTITIONING_RECORDER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "particle.hpp"
+
+// Trajectory file layout (little endian):
+//   TrajectoryHeader
+//   frames: TrajectoryFrameHeader followed by `payload_size` bytes
+// A frame payload holds, for every particle, the zigzag varint encoded difference between the
+// quantized position.x, position.y, velocity.x, velocity.y and the previous recorded frame.
+// Key frames are encoded against zero, so a reader can start from any of them.
+// The frame index is the simulation frame number: dropped frames show up as gaps between indices.
+const char trajectory_magic[4] = {'S', 'D', 'P', 'T'};
+const uint32_t trajectory_version = 2;
+// bytes of a 32 bits varint at worst
+const unsigned max_varint_size = 5;
+// the largest payload of a frame must fit its 32 bits payload_size
+const uint32_t max_trajectory_particles = UINT32_MAX / (4 * max_varint_size);
+
+struct TrajectoryHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t particles_count;
+    uint32_t keyframe_interval;
+    float position_step;
+    float velocity_step;
+};
+
+struct TrajectoryFrameHeader {
+    uint32_t index;
+    uint32_t keyframe;
+    float time;
+    uint32_t payload_size;
+};
+
+class TrajectoryRecorder {
+public:
+    TrajectoryRecorder(const std::string& path, unsigned count, float position_step = 1.f / 64.f,
+                       float velocity_step = 1.f / 64.f, unsigned keyframe_interval = 120);
+    ~TrajectoryRecorder();
+
+    TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+    // Encodes the frame and hands it to the writer thread. When the writer is still busy with the
+    // previous frame this one is dropped instead of waiting, the next delta is taken against the
+    // last frame that was actually recorded.
+    void capture(const Particle* particles, unsigned frame, float time);
+
+    bool is_open() const { return m_file.is_open(); }
+    unsigned get_recorded_frames() const { return m_recorded_frames; }
+    unsigned get_dropped_frames() const { return m_dropped_frames; }
+
+private:
+    void encode(const Particle* particles, unsigned index, float time);
+    void write_loop();
+
+    std::ofstream m_file;
+    unsigned m_count;
+    float m_position_step;
+    float m_velocity_step;
+    unsigned m_keyframe_interval;
+
+    std::vector<int32_t> m_previous;
+    std::vector<uint8_t> m_back;
+    std::vector<uint8_t> m_front;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::atomic<bool> m_front_busy{false};
+    bool m_stop = false;
+    std::thread m_writer;
+
+    unsigned m_recorded_frames = 0;
+    unsigned m_dropped_frames = 0;
+};
+
+class TrajectoryReader {
+public:
+    explicit TrajectoryReader(const std::string& path);
+
+    bool is_open() const { return m_valid; }
+    const TrajectoryHeader& get_header() const { return m_header; }
+
+    // Decodes the next frame into get_header().particles_count particles position and velocity, returns
+    // false at the end of the file or on a corrupted frame, which ends the reading
+    bool next_frame(Particle* particles, TrajectoryFrameHeader* frame = nullptr);
+
+private:
+    std::ifstream m_file;
+    TrajectoryHeader m_header = {};
+    bool m_valid = false;
+
+    std::vector<int32_t> m_previous;
+    std::vector<uint8_t> m_payload;
+};
+
+// Records every frame, meant to be passed to Application::register_system
+std::function<void()> recorder_system(TrajectoryRecorder* recorder, const Particle* particles);
+
+#endif //SPATIAL_DATA_PARTITIONING_RECORDER_HPP
@@ -0,0 +1,127 @@
+#include "renderer.hpp"
+#include "common.hpp"
+#include "shaders.hpp"
+
+#include <cstddef>
+#include <iostream>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+const unsigned low_circle_segments = 8;
+const unsigned circle_segments = 30;
+
+ParticleRenderer::ParticleRenderer() {
+    m_low_circle_vao = initCircle({0.0f, 0.0f}, 1.f, low_circle_segments);
+    m_circle_vao = initCircle({0.0f, 0.0f}, 1.f, circle_segments);
+
+    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 1, &pointVertexSource, nullptr);
+    glCompileShader(vertexShader);
+    checkShader(vertexShader);
+
+    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &pointFragmentSource, nullptr);
+    glCompileShader(fragmentShader);
+    checkShader(fragmentShader);
+
+    m_point_program = glCreateProgram();
+    glAttachShader(m_point_program, vertexShader);
+    glAttachShader(m_point_program, fragmentShader);
+    glLinkProgram(m_point_program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    glEnable(GL_PROGRAM_POINT_SIZE);
+
+    glGenVertexArrays(1, &m_point_vao);
+    glGenBuffers(1, &m_point_vbo);
+    glBindVertexArray(m_point_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_point_vbo);
+
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(PointVertex), (void*)offsetof(PointVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(PointVertex), (void*)offsetof(PointVertex, color));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(PointVertex), (void*)offsetof(PointVertex, size));
+    glEnableVertexAttribArray(2);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    unsigned shader_program = Application::get()->get_shader_program();
+    m_model_location = glGetUniformLocation(shader_program, "model");
+    m_color_location = glGetUniformLocation(shader_program, "color");
+    m_point_projection_location = glGetUniformLocation(m_point_program, "projection");
+}
+
+ParticleRenderer::~ParticleRenderer() {
+    glDeleteVertexArrays(1, &m_low_circle_vao);
+    glDeleteVertexArrays(1, &m_circle_vao);
+    glDeleteVertexArrays(1, &m_point_vao);
+    glDeleteBuffers(1, &m_point_vbo);
+    glDeleteProgram(m_point_program);
+}
+
+AABB ParticleRenderer::visible_range(float max_radius, float max_speed) {
+    AABB viewport = Application::get()->get_viewport();
+    float margin = max_radius + max_speed * Application::delta_time;
+
+    return {viewport.min - margin, viewport.max + margin};
+}
+
+void ParticleRenderer::draw_visible() {
+    float zoom = Application::get()->get_window().get_zoom();
+
+    m_points.clear();
+    m_low_detail.clear();
+    m_high_detail.clear();
+
+    for (Particle* particle : m_visible) {
+        float pixel_radius = particle->radius * zoom;
+
+        if (pixel_radius < point_lod_radius) {
+            m_points.push_back({particle->position, particle->color, glm::max(2.f * pixel_radius, 1.f)});
+        } else if (pixel_radius < low_lod_radius) {
+            m_low_detail.push_back(particle);
+        } else {
+            m_high_detail.push_back(particle);
+        }
+    }
+
+    draw_meshes(m_low_detail, m_low_circle_vao, low_circle_segments * 3);
+    draw_meshes(m_high_detail, m_circle_vao, circle_segments * 3);
+
+    if (!m_points.empty()) {
+        AABB viewport = Application::get()->get_viewport();
+        glm::mat4 projection = glm::ortho(viewport.min.x, viewport.max.x, viewport.min.y, viewport.max.y, -1000.0f, 1000.0f);
+
+        glUseProgram(m_point_program);
+        glUniformMatrix4fv(m_point_projection_location, 1, GL_FALSE, &projection[0][0]);
+
+        glBindVertexArray(m_point_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, m_point_vbo);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) (sizeof(PointVertex) * m_points.size()), m_points.data(), GL_STREAM_DRAW);
+        glDrawArrays(GL_POINTS, 0, (GLsizei) m_points.size());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glUseProgram(Application::get()->get_shader_program());
+    }
+}
+
+void ParticleRenderer::draw_meshes(const std::vector<Particle*>& particles, unsigned vao, unsigned index_count) {
+    if (particles.empty()) {
+        return;
+    }
+
+    glBindVertexArray(vao);
+
+    for (Particle* particle : particles) {
+        glm::mat4 model          = glm::mat4(1.0f);
+        model       = glm::translate(model, glm::vec3(particle->position, 0.0f));
+        model       = glm::scale(model, glm::vec3(particle->radius, particle->radius, 0.0f));
+
+        glUniformMatrix4fv(m_model_location, 1, GL_FALSE, &model[0][0]);
+        glUniform3fv(m_color_location, 1, &particle->color[0]);
+        glDrawElements(GL_TRIANGLES, (GLsizei) index_count, GL_UNSIGNED_INT, nullptr);
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef SPATIAL_DATA_PARTITIONING_RENDERER_HPP
+#define SPATIAL_DATA_PARTITIONING_RENDERER_HPP
+
+#include <vector>
+
+#include "aabb.hpp"
+#include "particle.hpp"
+
+// on-screen radius, in pixels, under which particles are drawn as point sprites
+const float point_lod_radius = 2.f;
+// on-screen radius, in pixels, under which particles are drawn with the low detail mesh
+const float low_lod_radius = 6.f;
+
+// Draws only the particles inside the viewport, found through the spatial index, and picks the
+// cheapest representation for their on-screen size: one batched draw of point sprites for tiny
+// particles, an 8 segments mesh for small ones and the full 30 segments circle otherwise.
+class ParticleRenderer {
+public:
+    ParticleRenderer();
+    ~ParticleRenderer();
+
+    ParticleRenderer(const ParticleRenderer&) = delete;
+    ParticleRenderer& operator=(const ParticleRenderer&) = delete;
+
+    template<typename Index>
+    void draw(Index& index)
+    {
+        m_visible.clear();
+        index.query_range(visible_range(index.get_max_radius(), index.get_max_speed()), &m_visible);
+        draw_visible();
+    }
+
+    unsigned get_visible_count() const { return (unsigned) m_visible.size(); }
+
+private:
+    struct PointVertex {
+        glm::vec2 position;
+        glm::vec3 color;
+        float size;
+    };
+
+    // viewport grown by the largest radius plus the distance the fastest particle moves in a frame,
+    // the index holds the centers of the last build and the particles moved since
+    AABB visible_range(float max_radius, float max_speed);
+    void draw_visible();
+    void draw_meshes(const std::vector<Particle*>& particles, unsigned vao, unsigned index_count);
+
+    unsigned m_low_circle_vao;
+    unsigned m_circle_vao;
+    unsigned m_point_vao;
+    unsigned m_point_vbo;
+    unsigned m_point_program;
+
+    int m_model_location;
+    int m_color_location;
+    int m_point_projection_location;
+
+    std::vector<Particle*> m_visible;
+    std::vector<Particle*> m_low_detail;
+    std::vector<Particle*> m_high_detail;
+    std::vector<PointVertex> m_points;
+};
+
+#endif //SPATIAL_DATA_PARTITIONING_RENDERER_HPP
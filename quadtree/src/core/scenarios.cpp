@@ -0,0 +1,265 @@
+#include "scenarios.hpp"
+
+#include <cmath>
+
+const float two_pi = 6.2831853f;
+
+static glm::vec2 random_direction(std::default_random_engine& generator)
+{
+    std::uniform_real_distribution<float> angle_distribution(0.f, two_pi);
+    float angle = angle_distribution(generator);
+
+    return {std::cos(angle), std::sin(angle)};
+}
+
+static glm::vec3 random_color(std::default_random_engine& generator)
+{
+    std::uniform_int_distribution<int> color_distribution(25, 100);
+
+    return {
+        (float) color_distribution(generator) / 100,
+        (float) color_distribution(generator) / 100,
+        (float) color_distribution(generator) / 100
+    };
+}
+
+// keeps the whole particle inside bounds
+static glm::vec2 clamp_inside(glm::vec2 position, float radius, const AABB& bounds)
+{
+    return glm::clamp(position, bounds.min + radius, bounds.max - radius);
+}
+
+// uniform positions, moving outward from the center. Close to the original init_particles, which drew
+// integer positions from an unseeded generator, so the same seed can't reproduce its runs
+static void generate_uniform(Particle* particles, unsigned count, const AABB& bounds, float radius, std::default_random_engine& generator)
+{
+    glm::vec2 center = (bounds.min + bounds.max) / 2.f;
+    std::uniform_real_distribution<float> x_distribution(bounds.min.x + radius, bounds.max.x - radius);
+    std::uniform_real_distribution<float> y_distribution(bounds.min.y + radius, bounds.max.y - radius);
+    std::uniform_int_distribution<int> velocity_distribution(10, 20);
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        Particle& particle = particles[i];
+        particle.position = {x_distribution(generator), y_distribution(generator)};
+
+        glm::vec2 outward = particle.position - center;
+        float length = glm::length(outward);
+        glm::vec2 direction = length > 0.f ? outward / length : glm::vec2(1.f, 0.f);
+        particle.velocity = direction * (float) velocity_distribution(generator);
+
+        particle.radius = radius;
+        particle.color = random_color(generator);
+    }
+}
+
+// dense gaussian clusters of about 2000 particles, each drifting as a whole
+static void generate_clustered(Particle* particles, unsigned count, const AABB& bounds, float radius, std::default_random_engine& generator)
+{
+    const unsigned particles_per_cluster = 2000;
+    unsigned cluster_count = glm::max(1u, count / particles_per_cluster);
+    // about the spread that would fit the cluster's particles side by side
+    float spread = 0.5f * radius * std::sqrt((float) particles_per_cluster);
+
+    // cluster centers keep away from the walls, as far as the world allows
+    glm::vec2 margin = glm::min(glm::vec2(2.f * spread), (bounds.max - bounds.min) / 2.f);
+    std::uniform_real_distribution<float> x_distribution(bounds.min.x + margin.x, bounds.max.x - margin.x);
+    std::uniform_real_distribution<float> y_distribution(bounds.min.y + margin.y, bounds.max.y - margin.y);
+    std::uniform_real_distribution<float> drift_distribution(10.f, 20.f);
+    std::uniform_real_distribution<float> jitter_distribution(0.f, 5.f);
+    std::normal_distribution<float> offset_distribution(0.f, spread);
+
+    std::vector<glm::vec2> centers(cluster_count);
+    std::vector<glm::vec2> drifts(cluster_count);
+    for (unsigned c = 0; c < cluster_count; c++)
+    {
+        centers[c] = {x_distribution(generator), y_distribution(generator)};
+        drifts[c] = random_direction(generator) * drift_distribution(generator);
+    }
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        Particle& particle = particles[i];
+        unsigned cluster = i % cluster_count;
+        glm::vec2 offset = {offset_distribution(generator), offset_distribution(generator)};
+
+        particle.position = clamp_inside(centers[cluster] + offset, radius, bounds);
+        particle.velocity = drifts[cluster] + random_direction(generator) * jitter_distribution(generator);
+        particle.radius = radius;
+        particle.color = random_color(generator);
+    }
+}
+
+// a single gaussian blob in the middle of the world
+static void generate_gaussian(Particle* particles, unsigned count, const AABB& bounds, float radius, std::default_random_engine& generator)
+{
+    glm::vec2 center = (bounds.min + bounds.max) / 2.f;
+    glm::vec2 size = bounds.max - bounds.min;
+    std::normal_distribution<float> offset_distribution(0.f, glm::min(size.x, size.y) / 6.f);
+    std::uniform_real_distribution<float> velocity_distribution(10.f, 20.f);
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        Particle& particle = particles[i];
+        glm::vec2 offset = {offset_distribution(generator), offset_distribution(generator)};
+
+        particle.position = clamp_inside(center + offset, radius, bounds);
+        particle.velocity = random_direction(generator) * velocity_distribution(generator);
+        particle.radius = radius;
+        particle.color = random_color(generator);
+    }
+}
+
+// two horizontal bands rushing at each other from the left and the right walls
+static void generate_streams(Particle* particles, unsigned count, const AABB& bounds, float radius, std::default_random_engine& generator)
+{
+    glm::vec2 center = (bounds.min + bounds.max) / 2.f;
+    glm::vec2 size = bounds.max - bounds.min;
+    float band = size.y / 6.f;
+    // the streams start apart and meet after a few seconds
+    float gap = size.x / 10.f;
+
+    std::uniform_real_distribution<float> x_distribution(0.f, glm::max(0.f, size.x / 2.f - gap - radius));
+    std::uniform_real_distribution<float> y_distribution(-band, band);
+    std::uniform_real_distribution<float> speed_distribution(40.f, 60.f);
+    std::uniform_real_distribution<float> jitter_distribution(-2.f, 2.f);
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        Particle& particle = particles[i];
+        float side = i % 2 == 0 ? -1.f : 1.f;
+        glm::vec2 position = {center.x + side * (gap + x_distribution(generator)), center.y + y_distribution(generator)};
+
+        particle.position = clamp_inside(position, radius, bounds);
+        particle.velocity = {-side * speed_distribution(generator), jitter_distribution(generator)};
+        particle.radius = radius;
+        particle.color = side < 0.f ? glm::vec3(1.f, 0.45f, 0.3f) : glm::vec3(0.3f, 0.6f, 1.f);
+    }
+}
+
+// everything piled up in a corner, one tenth of the world wide, the worst case for a tree fitted to the world
+static void generate_corner(Particle* particles, unsigned count, const AABB& bounds, float radius, std::default_random_engine& generator)
+{
+    glm::vec2 size = (bounds.max - bounds.min) / 10.f;
+    std::uniform_real_distribution<float> x_distribution(0.f, size.x);
+    std::uniform_real_distribution<float> y_distribution(0.f, size.y);
+    std::uniform_real_distribution<float> velocity_distribution(0.f, 5.f);
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        Particle& particle = particles[i];
+        glm::vec2 position = bounds.min + glm::vec2(x_distribution(generator), y_distribution(generator));
+
+        particle.position = clamp_inside(position, radius, bounds);
+        particle.velocity = random_direction(generator) * velocity_distribution(generator);
+        particle.radius = radius;
+        particle.color = random_color(generator);
+    }
+}
+
+// uniform positions with radii spread log-uniformly from half to five times radius
+static void generate_mixed_radii(Particle* particles, unsigned count, const AABB& bounds, float radius, std::default_random_engine& generator)
+{
+    std::uniform_real_distribution<float> log_radius_distribution(std::log(0.5f * radius), std::log(5.f * radius));
+    std::uniform_real_distribution<float> unit_distribution(0.f, 1.f);
+    std::uniform_real_distribution<float> velocity_distribution(10.f, 20.f);
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        Particle& particle = particles[i];
+        particle.radius = std::exp(log_radius_distribution(generator));
+
+        glm::vec2 room = glm::max(bounds.max - bounds.min - 2.f * particle.radius, glm::vec2(0.f));
+        glm::vec2 position = bounds.min + particle.radius + glm::vec2(unit_distribution(generator), unit_distribution(generator)) * room;
+
+        particle.position = clamp_inside(position, particle.radius, bounds);
+        particle.velocity = random_direction(generator) * velocity_distribution(generator);
+        particle.color = random_color(generator);
+    }
+}
+
+// particles at rest on a lattice spread over the world, one in a thousand shot through it: the lattice
+// falls asleep and wakes up where the projectiles hit it. Lattice neighbours don't touch as long as
+// count particles fit side by side.
+static void generate_resting(Particle* particles, unsigned count, const AABB& bounds, float radius, std::default_random_engine& generator)
+{
+    const unsigned projectile_interval = 1000;
+    glm::vec2 size = bounds.max - bounds.min;
+    unsigned columns = glm::max(1u, (unsigned) std::ceil(std::sqrt((float) count * size.x / size.y)));
+    unsigned rows = glm::max(1u, (count + columns - 1) / columns);
+    glm::vec2 spacing = size / glm::vec2(columns, rows);
+
+    std::uniform_real_distribution<float> speed_distribution(60.f, 100.f);
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        Particle& particle = particles[i];
+        glm::vec2 cell = {(float) (i % columns) + 0.5f, (float) (i / columns) + 0.5f};
+
+        particle.position = clamp_inside(bounds.min + cell * spacing, radius, bounds);
+        particle.radius = radius;
+
+        if (i % projectile_interval == 0)
+        {
+            particle.velocity = random_direction(generator) * speed_distribution(generator);
+            particle.color = {1.f, 0.3f, 0.2f};
+        }
+        else
+        {
+            particle.velocity = {0.f, 0.f};
+            particle.color = glm::vec3(0.6f);
+        }
+    }
+}
+
+static std::vector<Scenario>& scenarios()
+{
+    static std::vector<Scenario> scenarios = {
+        {"uniform", "uniform positions moving outward from the center", generate_uniform},
+        {"clustered", "dense gaussian clusters drifting as a whole", generate_clustered},
+        {"gaussian", "a single gaussian blob in the middle", generate_gaussian},
+        {"streams", "two bands colliding head on", generate_streams},
+        {"corner", "everything piled up in one corner", generate_corner},
+        {"mixed_radii", "uniform positions, radii from 0.5x to 5x", generate_mixed_radii},
+        {"resting", "a lattice at rest hit by a few projectiles", generate_resting},
+    };
+
+    return scenarios;
+}
+
+const std::vector<Scenario>& get_scenarios()
+{
+    return scenarios();
+}
+
+void register_scenario(const Scenario& scenario)
+{
+    scenarios().push_back(scenario);
+}
+
+const Scenario* find_scenario(const std::string& name)
+{
+    for (const Scenario& scenario : scenarios())
+    {
+        if (name == scenario.name)
+        {
+            return &scenario;
+        }
+    }
+
+    return nullptr;
+}
+
+void generate_particles(const Scenario& scenario, Particle* particles, unsigned count, const AABB& bounds, float radius, unsigned seed)
+{
+    auto generator = std::default_random_engine(seed);
+    scenario.generate(particles, count, bounds, radius, generator);
+}
+
+std::vector<Particle> generate_particles(const Scenario& scenario, unsigned count, const AABB& bounds, float radius, unsigned seed)
+{
+    std::vector<Particle> particles(count);
+    generate_particles(scenario, particles.data(), count, bounds, radius, seed);
+
+    return particles;
+}
@@ -0,0 +1,29 @@
+#ifndef SPATIAL_DATA_PARTITIONING_SCENARIOS_HPP
+#define SPATIAL_DATA_PARTITIONING_SCENARIOS_HPP
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "particle.hpp"
+#include "aabb.hpp"
+
+// Initial particle distributions. Generators only draw from the engine they receive, so a scenario
+// gives the same particles for the same seed, count and bounds. Positions stay inside bounds.
+struct Scenario {
+    const char* name;
+    const char* description;
+    // radius is the typical particle radius, generators may vary it
+    void (*generate)(Particle* particles, unsigned count, const AABB& bounds, float radius, std::default_random_engine& generator);
+};
+
+// built-in scenarios followed by the registered ones
+const std::vector<Scenario>& get_scenarios();
+void register_scenario(const Scenario& scenario);
+// nullptr when no scenario has this name
+const Scenario* find_scenario(const std::string& name);
+
+void generate_particles(const Scenario& scenario, Particle* particles, unsigned count, const AABB& bounds, float radius, unsigned seed);
+std::vector<Particle> generate_particles(const Scenario& scenario, unsigned count, const AABB& bounds, float radius, unsigned seed);
+
+#endif //SPATIAL_DATA_PARTITIONING_SCENARIOS_HPP
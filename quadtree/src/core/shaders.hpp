@@ -17,7 +17,7 @@
                                                             \
 }
 
-const char* vertexSource = R"glsl(
+const char* const vertexSource = R"glsl(
     #version 330 core
     layout(location = 0) in vec2 position;
 
@@ -31,7 +31,7 @@ const char* vertexSource = R"glsl(
 )glsl";
 
 
-const char* fragmentSource = R"glsl(
+const char* const fragmentSource = R"glsl(
     #version 330 core
     uniform vec3 color;
 
@@ -43,4 +43,39 @@ const char* fragmentSource = R"glsl(
     }
 )glsl";
 
+// batched particles drawn as round point sprites, used for particles too small for a mesh
+const char* const pointVertexSource = R"glsl(
+    #version 330 core
+    layout(location = 0) in vec2 position;
+    layout(location = 1) in vec3 color;
+    layout(location = 2) in float size;
+
+    uniform mat4 projection;
+
+    out vec3 pointColor;
+
+    void main()
+    {
+        gl_Position = projection * vec4(position, 1.0, 1.0);
+        gl_PointSize = size;
+        pointColor = color;
+    }
+)glsl";
+
+
+const char* const pointFragmentSource = R"glsl(
+    #version 330 core
+    in vec3 pointColor;
+
+    out vec4 outColor;
+
+    void main()
+    {
+        if (length(gl_PointCoord - vec2(0.5)) > 0.5)
+            discard;
+
+        outColor = vec4(pointColor, 1.0);
+    }
+)glsl";
+
 #endif //SPATIAL_DATA_PARTITIONING_SHADERS_HPP
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "simulation.hpp"
+
+void resolve_collision(Particle& particle, Particle& other)
+{
+    glm::vec2 distance = particle.position - other.position;
+    float magnitude = glm::length(distance);
+
+    glm::vec2 normal = glm::normalize(glm::vec2(other.position.x-particle.position.x, other.position.y-particle.position.y));
+
+    // apply force
+    float kx = (particle.velocity.x - other.velocity.x);
+    float ky = (particle.velocity.y - other.velocity.y);
+    float p = 2.0f * (normal.x * kx + normal.y * ky) / (particle.radius + other.radius);
+    particle.velocity.x = particle.velocity.x - p * other.radius * normal.x;
+    particle.velocity.y = particle.velocity.y - p * other.radius * normal.y;
+    other.velocity.x = other.velocity.x + p * particle.radius * normal.x;
+    other.velocity.y = other.velocity.y + p * particle.radius * normal.y;
+
+    // remove intersection
+    glm::vec2 forceDir = distance / magnitude;
+    glm::vec2 force = forceDir;
+    float intersectionLenght = particle.radius + other.radius - glm::length(particle.position - other.position);
+    glm::vec2 correction = force * intersectionLenght;
+
+    float max_distance = (particle.radius + other.radius);
+    particle.position += correction * particle.radius / max_distance;
+    other.position -= correction * other.radius / max_distance;
+}
+
+void resolve_bounds(Particle& particle, const AABB& bounds)
+{
+    float maxX = bounds.max.x - particle.radius;
+    float minX = bounds.min.x + particle.radius;
+
+    float maxY = bounds.max.y - particle.radius;
+    float minY = bounds.min.y + particle.radius;
+
+    // world bounds
+    if (particle.position.x <= minX)
+    {
+        particle.velocity.x = -particle.velocity.x;
+        particle.position.x = minX;
+    } else if (particle.position.x >= maxX ) {
+        particle.velocity.x = -particle.velocity.x;
+        particle.position.x = maxX;
+    }
+
+    if (particle.position.y <= minY)
+    {
+        particle.velocity.y = -particle.velocity.y;
+        particle.position.y = minY;
+    } else if (particle.position.y >= maxY)
+    {
+        particle.velocity.y = -particle.velocity.y;
+        particle.position.y = maxY;
+    }
+}
+
+void resolve_collision(Particle3D& particle, Particle3D& other)
+{
+    glm::vec3 distance = particle.position - other.position;
+    float magnitude = glm::length(distance);
+
+    glm::vec3 normal = -distance / magnitude;
+
+    // apply force
+    float p = 2.0f * glm::dot(normal, particle.velocity - other.velocity) / (particle.radius + other.radius);
+    particle.velocity -= p * other.radius * normal;
+    other.velocity += p * particle.radius * normal;
+
+    // remove intersection
+    float intersectionLenght = particle.radius + other.radius - magnitude;
+    glm::vec3 correction = -normal * intersectionLenght;
+
+    float max_distance = (particle.radius + other.radius);
+    particle.position += correction * particle.radius / max_distance;
+    other.position -= correction * other.radius / max_distance;
+}
+
+void resolve_bounds(Particle3D& particle, glm::vec3 min, glm::vec3 max)
+{
+    for (int d = 0; d < 3; d++)
+    {
+        float lower = min[d] + particle.radius;
+        float upper = max[d] - particle.radius;
+
+        if (particle.position[d] <= lower)
+        {
+            particle.velocity[d] = -particle.velocity[d];
+            particle.position[d] = lower;
+        } else if (particle.position[d] >= upper)
+        {
+            particle.velocity[d] = -particle.velocity[d];
+            particle.position[d] = upper;
+        }
+    }
+}
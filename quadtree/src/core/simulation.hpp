@@ -0,0 +1,200 @@
+#ifndef SPATIAL_DATA_PARTITIONING_SIMULATION_HPP
+#define SPATIAL_DATA_PARTITIONING_SIMULATION_HPP
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "particle.hpp"
+#include "aabb.hpp"
+#include "world.hpp"
+#include "activity.hpp"
+#include "islands.hpp"
+
+// elastic impulse between two intersecting particles, then push them apart
+void resolve_collision(Particle& particle, Particle& other);
+// bounce the particle back inside bounds
+void resolve_bounds(Particle& particle, const AABB& bounds);
+
+void resolve_collision(Particle3D& particle, Particle3D& other);
+void resolve_bounds(Particle3D& particle, glm::vec3 min, glm::vec3 max);
+
+// Steps the particles in [begin, end) using any spatial index backend (see spatial_index.hpp).
+// The index must already be built for the current positions.
+template<typename Index>
+void update_physics(Index& index, Particle* particles, unsigned begin, unsigned end, const World& world, float delta_time)
+{
+    index.for_each_pair(begin, end, [](Particle& particle, Particle& other) {
+        if (particle.intersect(other))
+        {
+            resolve_collision(particle, other);
+        }
+    });
+
+    for (unsigned i = begin; i < end; i++)
+    {
+        Particle& particle = particles[i];
+
+        resolve_bounds(particle, world.bounds);
+
+        //update physic values
+        particle.position += particle.velocity * delta_time;
+
+        // particle.velocity *= 0.998f;
+    }
+}
+
+// runs function(thread_index) on thread_count threads, the calling thread being the first one
+template<typename Function>
+void parallel_for(unsigned thread_count, Function&& function)
+{
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < thread_count; i++)
+    {
+        threads.emplace_back(function, i);
+    }
+
+    function(0u);
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+// Steps the simulation skipping sleeping particles. Contacts of the awake particles are grouped into
+// islands, which share no particle and are solved in parallel without locks.
+class IslandSolver {
+public:
+    explicit IslandSolver(const SleepThresholds& thresholds = {}, unsigned thread_count = std::thread::hardware_concurrency())
+        : m_thread_count(thread_count > 0 ? thread_count : 1), m_activity(thresholds), m_thread_contacts(m_thread_count) {}
+
+    template<typename Index>
+    void step(Index& index, Particle* particles, unsigned count, const World& world, float delta_time)
+    {
+        m_activity.resize(count);
+        unsigned thread_load = count / m_thread_count;
+
+        // broad-phase, sleeping particles don't look for contacts
+        parallel_for(m_thread_count, [&](unsigned thread) {
+            thread_local std::vector<Particle*> found;
+            std::vector<Contact>& contacts = m_thread_contacts[thread];
+            contacts.clear();
+
+            unsigned begin = thread_load * thread;
+            unsigned end = thread + 1 == m_thread_count ? count : begin + thread_load;
+
+            for (unsigned i = begin; i < end; i++)
+            {
+                if (m_activity.is_asleep(i))
+                {
+                    continue;
+                }
+
+                found.clear();
+                index.query(&particles[i], &found);
+
+                for (Particle* other : found)
+                {
+                    unsigned j = (unsigned) (other - particles);
+
+                    // a pair of awake particles is found from both sides, the lower index keeps it
+                    if (j == i || (j < i && !m_activity.is_asleep(j)))
+                    {
+                        continue;
+                    }
+
+                    if (particles[i].intersect(*other))
+                    {
+                        contacts.push_back({i, j});
+                    }
+                }
+            }
+        });
+
+        m_contacts.clear();
+        for (std::vector<Contact>& contacts : m_thread_contacts)
+        {
+            m_contacts.insert(m_contacts.end(), contacts.begin(), contacts.end());
+        }
+
+        // touched by an awake particle
+        for (const Contact& contact : m_contacts)
+        {
+            if (m_activity.is_asleep(contact.b))
+            {
+                m_activity.wake(contact.b);
+            }
+        }
+
+        m_islands.build(m_contacts, count);
+
+        std::atomic<unsigned> next_island{0};
+        parallel_for(m_thread_count, [&](unsigned) {
+            unsigned island;
+            while ((island = next_island++) < m_islands.get_island_count())
+            {
+                for (const Contact* contact = m_islands.begin(island); contact != m_islands.end(island); contact++)
+                {
+                    Particle& particle = particles[contact->a];
+                    Particle& other = particles[contact->b];
+
+                    // an earlier contact of the island may have pushed them apart
+                    if (!particle.intersect(other))
+                    {
+                        continue;
+                    }
+
+                    glm::vec2 particle_velocity = particle.velocity;
+                    glm::vec2 other_velocity = other.velocity;
+
+                    resolve_collision(particle, other);
+
+                    m_activity.record_impulse(contact->a, glm::length(particle.velocity - particle_velocity));
+                    m_activity.record_impulse(contact->b, glm::length(other.velocity - other_velocity));
+                }
+            }
+        });
+
+        parallel_for(m_thread_count, [&](unsigned thread) {
+            unsigned begin = thread_load * thread;
+            unsigned end = thread + 1 == m_thread_count ? count : begin + thread_load;
+
+            for (unsigned i = begin; i < end; i++)
+            {
+                if (m_activity.is_asleep(i))
+                {
+                    continue;
+                }
+
+                Particle& particle = particles[i];
+
+                resolve_bounds(particle, world.bounds);
+
+                //update physic values
+                particle.position += particle.velocity * delta_time;
+            }
+        });
+
+        m_activity.update(particles, count);
+    }
+
+    unsigned get_sleeping_count() const { return m_activity.get_sleeping_count(); }
+    unsigned get_island_count() const { return m_islands.get_island_count(); }
+
+    // sleeping particles and islands of the last step, for the stats
+    std::string describe() const
+    {
+        return "Sleeping: " + std::to_string(get_sleeping_count()) + " - Islands: " + std::to_string(get_island_count());
+    }
+
+private:
+    unsigned m_thread_count;
+    ActivityTracker m_activity;
+    ContactIslands m_islands;
+    std::vector<std::vector<Contact>> m_thread_contacts;
+    std::vector<Contact> m_contacts;
+};
+
+#endif //SPATIAL_DATA_PARTITIONING_SIMULATION_HPP
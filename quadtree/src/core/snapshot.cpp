@@ -0,0 +1,222 @@
+#include "snapshot.hpp"
+#include "application.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SNAPSHOT_MMAP 1
+#endif
+
+static uint64_t snapshot_stride(uint64_t count) {
+    uint64_t bytes = count * sizeof(float);
+    return (bytes + snapshot_alignment - 1) / snapshot_alignment * snapshot_alignment;
+}
+
+static float particle_value(const Particle& particle, SnapshotArray array) {
+    switch (array) {
+        case SnapshotArray::position_x: return particle.position.x;
+        case SnapshotArray::position_y: return particle.position.y;
+        case SnapshotArray::velocity_x: return particle.velocity.x;
+        case SnapshotArray::velocity_y: return particle.velocity.y;
+        case SnapshotArray::radius: return particle.radius;
+        case SnapshotArray::color_r: return particle.color.x;
+        case SnapshotArray::color_g: return particle.color.y;
+        case SnapshotArray::color_b: return particle.color.z;
+        default: return 0.f;
+    }
+}
+
+bool save_snapshot(const std::string& path, const Particle* particles, unsigned count) {
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+    header.version = snapshot_version;
+    header.header_size = snapshot_alignment;
+    header.array_count = (uint32_t) SnapshotArray::count;
+    header.particles_count = count;
+    header.stride = snapshot_stride(count);
+
+    // write next to the target and rename, so a reader never maps a half written file
+    std::string temp_path = path + ".tmp";
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cout << "ERROR::SNAPSHOT::OPEN_FAILED " << temp_path << std::endl;
+        return false;
+    }
+
+    std::vector<char> padding(snapshot_alignment, 0);
+    file.write((const char*) &header, sizeof(header));
+    file.write(padding.data(), snapshot_alignment - sizeof(header));
+
+    std::vector<float> column(header.stride / sizeof(float), 0.f);
+    for (uint32_t array = 0; array < header.array_count; array++) {
+        for (unsigned i = 0; i < count; i++) {
+            column[i] = particle_value(particles[i], (SnapshotArray) array);
+        }
+        file.write((const char*) column.data(), (std::streamsize) header.stride);
+    }
+
+    file.close();
+    if (!file) {
+        std::cout << "ERROR::SNAPSHOT::WRITE_FAILED " << temp_path << std::endl;
+        std::remove(temp_path.c_str());
+        return false;
+    }
+
+    // rename replaces the target atomically on POSIX, readers see either the old or the new file
+    bool renamed = std::rename(temp_path.c_str(), path.c_str()) == 0;
+#ifdef _WIN32
+    // Windows refuses to rename over an existing file, there replacing can't be atomic
+    if (!renamed) {
+        std::remove(path.c_str());
+        renamed = std::rename(temp_path.c_str(), path.c_str()) == 0;
+    }
+#endif
+    if (!renamed) {
+        std::cout << "ERROR::SNAPSHOT::RENAME_FAILED " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool load_snapshot(const std::string& path, Particle* particles, unsigned count) {
+    Snapshot snapshot(path);
+
+    if (!snapshot.is_valid()) {
+        return false;
+    }
+
+    if (snapshot.get_count() != count) {
+        std::cout << "ERROR::SNAPSHOT::COUNT_MISMATCH " << path << " has " << snapshot.get_count()
+                  << " particles, expected " << count << std::endl;
+        return false;
+    }
+
+    snapshot.copy_to(particles, count);
+    return true;
+}
+
+std::function<void()> snapshot_system(Particle* particles, unsigned count, std::string path, float interval) {
+    return [particles, count, path, interval, elapsed = 0.f]() mutable {
+        elapsed += Application::delta_time;
+        if (elapsed < interval) {
+            return;
+        }
+
+        elapsed = 0.f;
+        save_snapshot(path, particles, count);
+    };
+}
+
+Snapshot::Snapshot(const std::string& path) {
+#ifdef SNAPSHOT_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "ERROR::SNAPSHOT::OPEN_FAILED " << path << std::endl;
+        return;
+    }
+
+    struct stat info = {};
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* data = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            m_data = (const unsigned char*) data;
+            m_size = (size_t) info.st_size;
+            m_mapped = true;
+            madvise(data, m_size, MADV_SEQUENTIAL);
+        }
+    }
+    close(fd);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (file) {
+        m_size = (size_t) file.tellg();
+        auto* data = new unsigned char[m_size];
+        file.seekg(0);
+        file.read((char*) data, (std::streamsize) m_size);
+        m_data = data;
+    }
+#endif
+
+    if (!m_data) {
+        std::cout << "ERROR::SNAPSHOT::READ_FAILED " << path << std::endl;
+        return;
+    }
+
+    if (!validate(m_size)) {
+        std::cout << "ERROR::SNAPSHOT::INVALID_FILE " << path << std::endl;
+        m_header = nullptr;
+    }
+}
+
+Snapshot::~Snapshot() {
+#ifdef SNAPSHOT_MMAP
+    if (m_mapped) {
+        munmap((void*) m_data, m_size);
+    }
+#else
+    delete[] m_data;
+#endif
+}
+
+bool Snapshot::validate(size_t size) {
+    if (size < sizeof(SnapshotHeader)) {
+        return false;
+    }
+
+    auto* header = (const SnapshotHeader*) m_data;
+    if (std::memcmp(header->magic, snapshot_magic, sizeof(header->magic)) != 0 ||
+        header->version != snapshot_version ||
+        header->header_size < sizeof(SnapshotHeader) ||
+        header->header_size % snapshot_alignment != 0 ||
+        header->array_count < (uint32_t) SnapshotArray::count ||
+        header->stride % sizeof(float) != 0) {
+        return false;
+    }
+
+    // sizes come from the file, check every product against the file size before computing it
+    uint64_t file_size = size;
+    if (header->header_size > file_size ||
+        header->particles_count > header->stride / sizeof(float) ||
+        header->stride > (file_size - header->header_size) / header->array_count) {
+        return false;
+    }
+
+    m_header = header;
+    return true;
+}
+
+const float* Snapshot::get_array(SnapshotArray array) const {
+    if (!m_header) {
+        return nullptr;
+    }
+
+    return (const float*) (m_data + m_header->header_size + m_header->stride * (uint64_t) array);
+}
+
+void Snapshot::copy_to(Particle* particles, unsigned count) const {
+    const float* position_x = get_array(SnapshotArray::position_x);
+    const float* position_y = get_array(SnapshotArray::position_y);
+    const float* velocity_x = get_array(SnapshotArray::velocity_x);
+    const float* velocity_y = get_array(SnapshotArray::velocity_y);
+    const float* radius = get_array(SnapshotArray::radius);
+    const float* color_r = get_array(SnapshotArray::color_r);
+    const float* color_g = get_array(SnapshotArray::color_g);
+    const float* color_b = get_array(SnapshotArray::color_b);
+
+    for (unsigned i = 0; i < count && i < get_count(); i++) {
+        Particle& particle = particles[i];
+        particle.position = {position_x[i], position_y[i]};
+        particle.velocity = {velocity_x[i], velocity_y[i]};
+        particle.radius = radius[i];
+        particle.color = {color_r[i], color_g[i], color_b[i]};
+    }
+}
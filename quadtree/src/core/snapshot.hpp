@@ -0,0 +1,69 @@
+#ifndef SPATIAL_DATA_PARTITIONING_SNAPSHOT_HPP
+#define SPATIAL_DATA_PARTITIONING_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "particle.hpp"
+
+// Snapshot file layout (little endian):
+//   SnapshotHeader, padded to snapshot_alignment bytes
+//   one float array per SnapshotArray, each `stride` bytes apart and aligned to snapshot_alignment
+// Keeping the arrays separate (SoA) lets a mapped snapshot be consumed column by column.
+const char snapshot_magic[4] = {'S', 'D', 'P', 'S'};
+const uint32_t snapshot_version = 1;
+const uint32_t snapshot_alignment = 64;
+
+enum class SnapshotArray : uint32_t {
+    position_x,
+    position_y,
+    velocity_x,
+    velocity_y,
+    radius,
+    color_r,
+    color_g,
+    color_b,
+    count
+};
+
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t array_count;
+    uint64_t particles_count;
+    uint64_t stride;
+};
+
+bool save_snapshot(const std::string& path, const Particle* particles, unsigned count);
+bool load_snapshot(const std::string& path, Particle* particles, unsigned count);
+
+// Periodically saves the particles, meant to be passed to Application::register_system
+std::function<void()> snapshot_system(Particle* particles, unsigned count, std::string path, float interval);
+
+// Read-only view over a snapshot file, memory mapped where the platform allows it
+class Snapshot {
+public:
+    explicit Snapshot(const std::string& path);
+    ~Snapshot();
+
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    bool is_valid() const { return m_header != nullptr; }
+    uint64_t get_count() const { return m_header ? m_header->particles_count : 0; }
+    const float* get_array(SnapshotArray array) const;
+
+    void copy_to(Particle* particles, unsigned count) const;
+
+private:
+    bool validate(size_t size);
+
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+    const SnapshotHeader* m_header = nullptr;
+};
+
+#endif //SPATIAL_DATA_PARTITIONING_SNAPSHOT_HPP
@@ -0,0 +1,120 @@
+#include "spatial_index.hpp"
+
+void NeighborListIndex::build(Particle* particles, unsigned count, const World& world, float delta_time)
+{
+    m_delta_time = delta_time;
+    m_steps_since_rebuild++;
+
+    // lists lasting a single step cost more than querying the tree, they're only tried again once in a while
+    if (m_direct && m_steps_since_rebuild < direct_probe_interval * m_rebuild_interval)
+    {
+        m_tree.build(particles, count, world, delta_time);
+        m_particles = particles;
+        m_count = count;
+        m_rebuild_count++;
+        return;
+    }
+
+    if (m_direct || needs_rebuild(particles, count))
+    {
+        rebuild(particles, count, world);
+    }
+}
+
+bool NeighborListIndex::needs_rebuild(Particle* particles, unsigned count)
+{
+    if (particles != m_particles || count != m_count)
+    {
+        return true;
+    }
+
+    float max_displacement2 = (m_skin / 2.f) * (m_skin / 2.f);
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        glm::vec2 displacement = particles[i].position - m_reference_positions[i];
+        if (glm::dot(displacement, displacement) > max_displacement2)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void NeighborListIndex::rebuild(Particle* particles, unsigned count, const World& world)
+{
+    m_tree.build(particles, count, world, m_delta_time);
+
+    // overlap corrections move particles further than their velocity does, in dense scenes the lists
+    // then expire long before the interval and a smaller skin wastes less on longer lists
+    if (m_direct)
+    {
+        m_direct = false;
+        m_interval = m_rebuild_interval;
+    }
+    else if (particles == m_particles && count == m_count)
+    {
+        if (m_steps_since_rebuild == 1)
+        {
+            m_direct = true;
+        }
+        else if (2 * m_steps_since_rebuild <= m_interval)
+        {
+            m_interval = glm::max(m_interval / 2, 1u);
+        }
+        else if (m_steps_since_rebuild >= m_interval)
+        {
+            m_interval = glm::min(m_interval * 2, m_rebuild_interval);
+        }
+    }
+
+    m_particles = particles;
+    m_count = count;
+    m_rebuild_count++;
+    m_steps_since_rebuild = 0;
+
+    if (m_direct)
+    {
+        m_skin = 0.f;
+        return;
+    }
+
+    // the tree build already found the largest radius and speed
+    float max_radius = m_tree.get_max_radius();
+    float max_speed = m_tree.get_max_speed();
+    m_reference_positions.resize(count);
+    for (unsigned i = 0; i < count; i++)
+    {
+        m_reference_positions[i] = particles[i].position;
+    }
+
+    // collisions can speed a particle up, the displacement check still catches it, only earlier.
+    // The floor keeps resting particles from rebuilding for every rounding error.
+    m_skin = glm::max(2.f * max_speed * m_delta_time * (float) m_interval, min_neighbor_skin);
+
+    m_offsets.resize(count + 1);
+    m_neighbors.clear();
+
+    std::vector<Particle*> found;
+    for (unsigned i = 0; i < count; i++)
+    {
+        Particle& particle = particles[i];
+        m_offsets[i] = (unsigned) m_neighbors.size();
+
+        found.clear();
+        m_tree.query_radius(particle.position, particle.radius + max_radius + m_skin, &found);
+
+        for (Particle* other : found)
+        {
+            float reach = particle.radius + other->radius + m_skin;
+            glm::vec2 delta = other->position - particle.position;
+
+            if (other != &particle && glm::dot(delta, delta) <= reach * reach)
+            {
+                m_neighbors.push_back((unsigned) (other - particles));
+            }
+        }
+    }
+    m_offsets[count] = (unsigned) m_neighbors.size();
+}
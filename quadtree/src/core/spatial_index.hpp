@@ -0,0 +1,406 @@
+#ifndef SPATIAL_DATA_PARTITIONING_SPATIAL_INDEX_HPP
+#define SPATIAL_DATA_PARTITIONING_SPATIAL_INDEX_HPP
+
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "particle.hpp"
+#include "quadtree.h"
+#include "spatial_tree.hpp"
+#include "world.hpp"
+
+// A spatial index backend is any class providing:
+//
+//   static const char* name();
+//   void build(Particle* particles, unsigned count, const World& world, float delta_time);
+//   void query(Particle* particle, std::vector<Particle*>* found);
+//   void query_range(const AABB& range, std::vector<Particle*>* found);
+//   template<typename Function> void for_each_pair(unsigned begin, unsigned end, Function&& function);
+//   void draw(unsigned vao, unsigned shader_program);
+//   unsigned depth() const;    // depth of the deepest tree node, 1 for flat backends
+//   float get_max_radius() const;  // largest radius and speed of the particles at the last build,
+//   float get_max_speed() const;   // gathered while build walks them
+//
+// build is called once per step before the particles move by delta_time, backends keeping their structure
+// across steps size it from it. for_each_pair calls function(particle, other) once for every candidate pair whose lower index lies in
+// [begin, end), so disjoint ranges can be processed by different threads. Backends are plain classes and
+// update_physics is templated on them, so the broad-phase is inlined into the step without virtual calls.
+
+// what a walk over the particles tells a build
+struct ParticleExtent {
+    // grown to hold every particle with a finite position
+    AABB bounds;
+    float max_radius;
+    float max_speed;
+};
+
+inline ParticleExtent fit_bounds(const Particle* particles, unsigned count, AABB bounds)
+{
+    float max_radius = 0.f, max_speed2 = 0.f;
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        glm::vec2 position = particles[i].position;
+        if (std::isfinite(position.x) && std::isfinite(position.y))
+        {
+            bounds.min = glm::min(bounds.min, position);
+            bounds.max = glm::max(bounds.max, position);
+        }
+
+        max_radius = glm::max(max_radius, particles[i].radius);
+        max_speed2 = glm::max(max_speed2, glm::dot(particles[i].velocity, particles[i].velocity));
+    }
+
+    return {bounds, max_radius, std::sqrt(max_speed2)};
+}
+
+class BruteForceIndex {
+public:
+    static const char* name() { return "Brute force"; }
+
+    void build(Particle* particles, unsigned count, const World& world, float)
+    {
+        m_particles = particles;
+        m_count = count;
+        m_extent = fit_bounds(particles, count, world.bounds);
+    }
+
+    void query(Particle* particle, std::vector<Particle*>* found)
+    {
+        for (unsigned i = 0; i < m_count; i++)
+        {
+            if (&m_particles[i] != particle)
+            {
+                found->push_back(&m_particles[i]);
+            }
+        }
+    }
+
+    void query_range(const AABB& range, std::vector<Particle*>* found)
+    {
+        for (unsigned i = 0; i < m_count; i++)
+        {
+            if (range.contains(m_particles[i].position))
+            {
+                found->push_back(&m_particles[i]);
+            }
+        }
+    }
+
+    template<typename Function>
+    void for_each_pair(unsigned begin, unsigned end, Function&& function)
+    {
+        for (unsigned i = begin; i < end; i++)
+        {
+            for (unsigned j = i + 1; j < m_count; j++)
+            {
+                function(m_particles[i], m_particles[j]);
+            }
+        }
+    }
+
+    void draw(unsigned, unsigned) {}
+
+    unsigned depth() const { return 1; }
+
+    float get_max_radius() const { return m_extent.max_radius; }
+    float get_max_speed() const { return m_extent.max_speed; }
+
+private:
+    Particle* m_particles = nullptr;
+    unsigned m_count = 0;
+    ParticleExtent m_extent = {};
+};
+
+// What TreeIndex needs from a tree type besides insert, query, draw and depth
+template<typename Tree>
+struct TreeTraits;
+
+template<>
+struct TreeTraits<QuadTree> {
+    static const char* name() { return "Quadtree"; }
+
+    static std::unique_ptr<QuadTree> make(const AABB& bounds, unsigned capacity)
+    {
+        return std::make_unique<QuadTree>(bounds, capacity);
+    }
+
+    static void query_range(QuadTree& tree, const AABB& range, std::vector<Particle*>* found)
+    {
+        tree.query_range(range, found);
+    }
+};
+
+// the capacity is a template parameter of the tree, the runtime one is ignored
+template<unsigned Capacity>
+struct TreeTraits<SpatialTree<2, Capacity>> {
+    static const char* name() { return "Spatial tree"; }
+
+    static std::unique_ptr<SpatialTree<2, Capacity>> make(const AABB& bounds, unsigned)
+    {
+        return std::make_unique<SpatialTree<2, Capacity>>((bounds.min + bounds.max) / 2.f, (bounds.max - bounds.min) / 2.f);
+    }
+
+    static void query_range(SpatialTree<2, Capacity>& tree, const AABB& range, std::vector<Particle*>* found)
+    {
+        tree.query_range(range.min, range.max, found);
+    }
+};
+
+// Index over a tree rebuilt every step, QuadTree or the compile time specialized SpatialTree<2, Capacity>
+template<typename Tree>
+class TreeIndex {
+public:
+    explicit TreeIndex(unsigned capacity = 6) : m_capacity(capacity) {}
+
+    static const char* name() { return TreeTraits<Tree>::name(); }
+
+    // the root is fitted to the world and the particles, particles the tree still can't hold
+    // (non finite positions) are kept in an overflow list checked by every query
+    void build(Particle* particles, unsigned count, const World& world, float)
+    {
+        m_extent = fit_bounds(particles, count, world.bounds);
+
+        m_particles = particles;
+        m_tree = TreeTraits<Tree>::make(m_extent.bounds, m_capacity);
+        m_overflow.clear();
+
+        for (unsigned i = 0; i < count; i++)
+        {
+            if (!m_tree->insert(&particles[i]))
+            {
+                m_overflow.push_back(&particles[i]);
+            }
+        }
+
+        // indices may be built from several threads, one per node
+        static std::atomic<bool> warned(false);
+        if (!m_overflow.empty() && !warned.exchange(true))
+        {
+            std::cout << "WARNING::QUADTREE::PARTICLES_OUTSIDE_ROOT " << m_overflow.size() << std::endl;
+        }
+    }
+
+    void query(Particle* particle, std::vector<Particle*>* found)
+    {
+        m_tree->query(particle, found);
+
+        for (Particle* other : m_overflow)
+        {
+            if (other != particle)
+            {
+                found->push_back(other);
+            }
+        }
+    }
+
+    void query_range(const AABB& range, std::vector<Particle*>* found)
+    {
+        TreeTraits<Tree>::query_range(*m_tree, range, found);
+
+        for (Particle* other : m_overflow)
+        {
+            if (range.contains(other->position))
+            {
+                found->push_back(other);
+            }
+        }
+    }
+
+    // QuadTree only
+    void query_radius(glm::vec2 center, float radius, std::vector<Particle*>* found)
+    {
+        m_tree->query_radius(center, radius, found);
+
+        for (Particle* other : m_overflow)
+        {
+            if (glm::distance(other->position, center) <= radius)
+            {
+                found->push_back(other);
+            }
+        }
+    }
+
+    template<typename Function>
+    void for_each_pair(unsigned begin, unsigned end, Function&& function)
+    {
+        // reused across calls, one per thread
+        thread_local std::vector<Particle*> found;
+
+        for (unsigned i = begin; i < end; i++)
+        {
+            Particle& particle = m_particles[i];
+
+            found.clear();
+            query(&particle, &found);
+
+            for (Particle* other : found)
+            {
+                // the pair is also found from the other particle, only the lower index handles it
+                if (other > &particle)
+                {
+                    function(particle, *other);
+                }
+            }
+        }
+    }
+
+    void draw(unsigned vao, unsigned shader_program)
+    {
+        m_tree->draw(vao, shader_program);
+    }
+
+    unsigned depth() const { return m_tree ? m_tree->depth() : 0; }
+
+    float get_max_radius() const { return m_extent.max_radius; }
+    float get_max_speed() const { return m_extent.max_speed; }
+
+private:
+    unsigned m_capacity;
+    Particle* m_particles = nullptr;
+    ParticleExtent m_extent = {};
+    std::unique_ptr<Tree> m_tree;
+    std::vector<Particle*> m_overflow;
+};
+
+using QuadTreeIndex = TreeIndex<QuadTree>;
+
+template<unsigned Capacity = 6>
+using SpatialTreeIndex = TreeIndex<SpatialTree<2, Capacity>>;
+
+// smallest skin of the neighbor lists, in pixels
+const float min_neighbor_skin = 0.1f;
+// rebuild intervals the neighbor lists wait before being tried again once they fell back to the tree
+const unsigned direct_probe_interval = 4;
+
+// Verlet neighbor lists: every particle keeps the particles within radius + other radius + skin in a
+// flat CSR array (m_neighbors[m_offsets[i]..m_offsets[i + 1]]). As long as no particle moved more than
+// skin / 2 since the lists were built no contact can be missing, so build() only rebuilds the quadtree
+// and the lists once that happens and the broad-phase cost is shared by several steps.
+// The skin is derived at every rebuild from the fastest particle, so that it would need rebuild_interval
+// steps of delta_time to move skin / 2: a longer interval means fewer rebuilds but longer lists. When the
+// lists expire early the interval aimed at is halved, and when they only serve a single step, as in dense
+// piles where overlap corrections move particles further than their velocity, the quadtree is queried
+// directly for a while.
+// It only wins on sparse or settled scenes, uniform and resting in benchmark_broadphase. Clustered,
+// gaussian, streams, corner and mixed_radii rebuild on every step (60/60) and cost a bit more than
+// QuadTreeIndex alone.
+class NeighborListIndex {
+public:
+    explicit NeighborListIndex(unsigned rebuild_interval = 4, unsigned capacity = 6)
+        : m_rebuild_interval(glm::max(rebuild_interval, 1u)), m_tree(capacity),
+          m_interval(m_rebuild_interval) {}
+
+    static const char* name() { return "Neighbor list"; }
+
+    // delta_time is the step about to be taken, the skin of the next rebuild is sized from it
+    void build(Particle* particles, unsigned count, const World& world, float delta_time);
+
+    void query(Particle* particle, std::vector<Particle*>* found)
+    {
+        if (m_direct)
+        {
+            m_tree.query(particle, found);
+            return;
+        }
+
+        unsigned i = (unsigned) (particle - m_particles);
+        for (unsigned k = m_offsets[i]; k < m_offsets[i + 1]; k++)
+        {
+            found->push_back(&m_particles[m_neighbors[k]]);
+        }
+    }
+
+    void query_range(const AABB& range, std::vector<Particle*>* found)
+    {
+        // the tree was built with the positions of the last rebuild, which are at most skin / 2 away
+        thread_local std::vector<Particle*> candidates;
+        float margin = m_skin / 2.f;
+
+        candidates.clear();
+        m_tree.query_range({range.min - margin, range.max + margin}, &candidates);
+
+        for (Particle* particle : candidates)
+        {
+            if (range.contains(particle->position))
+            {
+                found->push_back(particle);
+            }
+        }
+    }
+
+    template<typename Function>
+    void for_each_pair(unsigned begin, unsigned end, Function&& function)
+    {
+        if (m_direct)
+        {
+            m_tree.for_each_pair(begin, end, function);
+            return;
+        }
+
+        for (unsigned i = begin; i < end; i++)
+        {
+            for (unsigned k = m_offsets[i]; k < m_offsets[i + 1]; k++)
+            {
+                unsigned j = m_neighbors[k];
+                if (j > i)
+                {
+                    function(m_particles[i], m_particles[j]);
+                }
+            }
+        }
+    }
+
+    void draw(unsigned vao, unsigned shader_program)
+    {
+        m_tree.draw(vao, shader_program);
+    }
+
+    unsigned depth() const { return m_tree.depth(); }
+
+    // of the last rebuild, query_range covers the distance moved since
+    float get_max_radius() const { return m_tree.get_max_radius(); }
+    float get_max_speed() const { return m_tree.get_max_speed(); }
+
+    // the tree rebuilds while the lists aren't used count as well
+    unsigned get_rebuild_count() const { return m_rebuild_count; }
+    // 0 while the tree is queried directly
+    float get_skin() const { return m_skin; }
+
+private:
+    bool needs_rebuild(Particle* particles, unsigned count);
+    void rebuild(Particle* particles, unsigned count, const World& world);
+
+    unsigned m_rebuild_interval;
+    float m_delta_time = 0.f;
+    float m_skin = 0.f;
+    QuadTreeIndex m_tree;
+    // steps the current skin is sized for
+    unsigned m_interval;
+    bool m_direct = false;
+
+    Particle* m_particles = nullptr;
+    unsigned m_count = 0;
+    unsigned m_rebuild_count = 0;
+    unsigned m_steps_since_rebuild = 0;
+
+    std::vector<glm::vec2> m_reference_positions;
+    std::vector<unsigned> m_offsets;
+    std::vector<unsigned> m_neighbors;
+};
+
+// Broad-phase used by the collisions_index example, selected with the SPATIAL_INDEX CMake option
+#if defined(SPATIAL_INDEX_BRUTE_FORCE)
+using SelectedIndex = BruteForceIndex;
+#elif defined(SPATIAL_INDEX_NEIGHBOR_LIST)
+using SelectedIndex = NeighborListIndex;
+#elif defined(SPATIAL_INDEX_SPATIAL_TREE)
+using SelectedIndex = SpatialTreeIndex<>;
+#else
+using SelectedIndex = QuadTreeIndex;
+#endif
+
+#endif //SPATIAL_DATA_PARTITIONING_SPATIAL_INDEX_HPP
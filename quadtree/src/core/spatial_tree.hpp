@@ -0,0 +1,257 @@
+#ifndef SPATIAL_DATA_PARTITIONING_SPATIAL_TREE_HPP
+#define SPATIAL_DATA_PARTITIONING_SPATIAL_TREE_HPP
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "particle.hpp"
+
+// Dimension generic version of QuadTree: a quadtree for Dim = 2 and an octree for Dim = 3.
+// The number of children (2^Dim), the child a point belongs to and the bounds tests are all
+// resolved at compile time; loops over Dim unroll, and inserting descends straight into the one
+// child holding the point instead of trying each child in turn. Children are allocated together.
+template<int Dim, unsigned Capacity>
+class SpatialTree {
+public:
+    using vec = glm::vec<Dim, float>;
+    using Element = typename ParticleOf<Dim>::type;
+
+    static constexpr unsigned child_count = 1u << Dim;
+
+    SpatialTree(vec center, vec half_size) : m_center(center), m_half_size(half_size) {}
+
+    bool insert(Element* element)
+    {
+        if (!contains(element->position))
+        {
+            return false;
+        }
+
+        insert_inside(element);
+        return true;
+    }
+
+    // elements that may touch element
+    void query(Element* element, std::vector<Element*>* found)
+    {
+        if (!intersect(element->position, element->radius + m_max_radius))
+        {
+            return;
+        }
+
+        for (unsigned i = 0; i < m_count; i++)
+        {
+            if (m_elements[i] != element)
+            {
+                found->push_back(m_elements[i]);
+            }
+        }
+
+        for (Element* other : m_overflow)
+        {
+            if (other != element)
+            {
+                found->push_back(other);
+            }
+        }
+
+        if (m_children)
+        {
+            for (unsigned i = 0; i < child_count; i++)
+            {
+                m_children[i].query(element, found);
+            }
+        }
+    }
+
+    // elements whose position lies inside [min, max]
+    void query_range(vec min, vec max, std::vector<Element*>* found)
+    {
+        bool overlaps = true;
+        for (int d = 0; d < Dim; d++)
+        {
+            overlaps &= m_center[d] - m_half_size[d] <= max[d];
+            overlaps &= m_center[d] + m_half_size[d] >= min[d];
+        }
+
+        if (!overlaps)
+        {
+            return;
+        }
+
+        auto inside = [&min, &max](vec position) {
+            bool result = true;
+            for (int d = 0; d < Dim; d++)
+            {
+                result &= position[d] >= min[d];
+                result &= position[d] <= max[d];
+            }
+            return result;
+        };
+
+        for (unsigned i = 0; i < m_count; i++)
+        {
+            if (inside(m_elements[i]->position))
+            {
+                found->push_back(m_elements[i]);
+            }
+        }
+
+        for (Element* other : m_overflow)
+        {
+            if (inside(other->position))
+            {
+                found->push_back(other);
+            }
+        }
+
+        if (m_children)
+        {
+            for (unsigned i = 0; i < child_count; i++)
+            {
+                m_children[i].query_range(min, max, found);
+            }
+        }
+    }
+
+    // depth of the deepest node, the root being 1
+    unsigned depth() const
+    {
+        unsigned deepest = 0;
+        if (m_children)
+        {
+            for (unsigned i = 0; i < child_count; i++)
+            {
+                deepest = glm::max(deepest, m_children[i].depth());
+            }
+        }
+        return deepest + 1;
+    }
+
+    void draw(unsigned vao, unsigned shader_program)
+    {
+        static_assert(Dim == 2, "only quadtrees can be drawn");
+
+        static float color[3] = {1.f,1.f,1.f};
+        glm::mat4 model          = glm::mat4(1.0f);
+        model       = glm::translate(model, glm::vec3(m_center, 0.0f));
+        model       = glm::scale(model, glm::vec3(m_half_size, 0.0f));
+
+        glUniformMatrix4fv(glGetUniformLocation(shader_program, "model"), 1, GL_FALSE, &model[0][0]);
+        glUniform3fv(glGetUniformLocation(shader_program, "color"), 1, &color[0]);
+        glBindVertexArray(vao);
+        glDrawElements(GL_LINES, 8, GL_UNSIGNED_INT, 0);
+
+        if (m_children)
+        {
+            for (unsigned i = 0; i < child_count; i++)
+            {
+                m_children[i].draw(vao, shader_program);
+            }
+        }
+    }
+
+private:
+    SpatialTree() = default;
+
+    // child holding position: bit d is set when position is past the center along axis d
+    unsigned child_index(vec position) const
+    {
+        unsigned index = 0;
+        for (int d = 0; d < Dim; d++)
+        {
+            index |= (unsigned) (position[d] >= m_center[d]) << d;
+        }
+        return index;
+    }
+
+    bool contains(vec position) const
+    {
+        bool inside = true;
+        for (int d = 0; d < Dim; d++)
+        {
+            inside &= position[d] >= m_center[d] - m_half_size[d];
+            inside &= position[d] <= m_center[d] + m_half_size[d];
+        }
+        return inside;
+    }
+
+    bool intersect(vec position, float reach) const
+    {
+        bool inside = true;
+        for (int d = 0; d < Dim; d++)
+        {
+            inside &= position[d] >= m_center[d] - (m_half_size[d] + reach);
+            inside &= position[d] <= m_center[d] + (m_half_size[d] + reach);
+        }
+        return inside;
+    }
+
+    void insert_inside(Element* element)
+    {
+        m_max_radius = glm::max(m_max_radius, element->radius);
+
+        if (m_count < Capacity)
+        {
+            m_elements[m_count++] = element;
+            return;
+        }
+
+        if (!m_children)
+        {
+            // particles piled on the same point would subdivide forever
+            bool splittable = false;
+            for (int d = 0; d < Dim; d++)
+            {
+                splittable |= m_half_size[d] >= 1e-3f;
+            }
+
+            if (!splittable)
+            {
+                m_overflow.push_back(element);
+                return;
+            }
+
+            subdivide();
+        }
+
+        m_children[child_index(element->position)].insert_inside(element);
+    }
+
+    void subdivide()
+    {
+        vec half_size = m_half_size / 2.f;
+
+        m_children.reset(new SpatialTree[child_count]);
+        for (unsigned i = 0; i < child_count; i++)
+        {
+            SpatialTree& child = m_children[i];
+            for (int d = 0; d < Dim; d++)
+            {
+                child.m_center[d] = m_center[d] + ((i >> d) & 1 ? half_size[d] : -half_size[d]);
+            }
+            child.m_half_size = half_size;
+        }
+    }
+
+    vec m_center;
+    vec m_half_size;
+    float m_max_radius = 0.f;
+
+    std::array<Element*, Capacity> m_elements;
+    unsigned m_count = 0;
+    // only used by nodes too small to subdivide
+    std::vector<Element*> m_overflow;
+
+    std::unique_ptr<SpatialTree[]> m_children;
+};
+
+using QuadTree2D = SpatialTree<2, 6>;
+using Octree = SpatialTree<3, 6>;
+
+#endif //SPATIAL_DATA_PARTITIONING_SPATIAL_TREE_HPP
@@ -49,6 +49,12 @@ Window::Window(WindowData data) : data(data) {
 //        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, &projection[0][0]);
         glViewport(0, 0, width, height);
     });
+
+    glfwSetScrollCallback(native_window, [](GLFWwindow* window, double, double y_offset) {
+        WindowData& data = *(WindowData*)glfwGetWindowUserPointer(window);
+        data.zoom *= y_offset > 0 ? 1.1f : 1.f / 1.1f;
+        data.zoom = glm::clamp(data.zoom, 0.05f, 50.f);
+    });
 }
 
 Window::~Window() {
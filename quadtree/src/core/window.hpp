@@ -10,6 +10,8 @@ struct WindowData {
     std::string title;
     int width;
     int height;
+    // world units to pixels, changed with the mouse wheel
+    float zoom = 1.f;
 };
 
 class Window {
@@ -19,6 +21,7 @@ public:
     std::string_view get_title() const { return data.title; }
     int get_width() const { return data.width; }
     int get_height() const { return data.height; }
+    float get_zoom() const { return data.zoom; }
 
     explicit Window(WindowData data);
     ~Window();
@@ -0,0 +1,15 @@
+#ifndef SPATIAL_DATA_PARTITIONING_WORLD_HPP
+#define SPATIAL_DATA_PARTITIONING_WORLD_HPP
+
+#include "aabb.hpp"
+
+// Region the particles live in. It's independent of the window, resizing or zooming doesn't move the
+// walls, and the simulation receives it once per step instead of asking the window for every particle.
+struct World {
+    AABB bounds;
+
+    glm::vec2 get_size() const { return bounds.max - bounds.min; }
+    glm::vec2 get_center() const { return (bounds.min + bounds.max) / 2.f; }
+};
+
+#endif //SPATIAL_DATA_PARTITIONING_WORLD_HPP